@@ -0,0 +1,427 @@
+/**
+ * @file bench.c
+ * @brief Microbenchmarks for the hot paths of the simulation.
+ * * Every benchmark runs one operation over and over on a fixed scene (same
+ * seed, played to the same tick), so numbers from two builds of the engine
+ * are comparable. Results are written as JSON: nanoseconds and heap
+ * allocations per operation for each benchmark. Allocations are counted by
+ * wrapping malloc / calloc / realloc at link time (GNU ld); elsewhere they
+ * are reported as -1.
+ *
+ * Built only with -DSOCCER_BUILD_BENCH=ON.
+ *
+ * Usage: soccerbench [--filter TEXT] [--min-time SECONDS] [--seed S] [--team-size P]
+ * Only benchmarks whose name contains TEXT are run. Each one runs for at
+ * least SECONDS (default 0.2). The scene has P players per team (default
+ * PLAYER_COUNT), except for the scaling/ benchmarks, which pick their own
+ * size to show how the cost of a tick grows with the number of players.
+ */
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core/clock.h"
+#include "core/vec2.h"
+#include "entities/ball.h"
+#include "entities/team.h"
+#include "game/passing.h"
+#include "game/possession.h"
+#include "game/scene.h"
+#include "game/spatial_grid.h"
+#include "game/sweep.h"
+#include "logic/referee.h"
+
+#define WARM_TICKS 600  // the fixed scene: 10 s into the match
+#define VEC_COUNT 1024  // vec2 benchmarks cycle through this many inputs
+
+// ---------------------------------------------------------------------------
+// Allocation counting
+
+#ifdef BENCH_COUNT_ALLOCS
+static unsigned long long allocations;
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+
+void* __wrap_malloc(size_t size) { allocations++; return __real_malloc(size); }
+void* __wrap_calloc(size_t count, size_t size) { allocations++; return __real_calloc(count, size); }
+void* __wrap_realloc(void* ptr, size_t size) { allocations++; return __real_realloc(ptr, size); }
+
+static unsigned long long allocation_count(void) { return allocations; }
+#else
+static unsigned long long allocation_count(void) { return 0; }
+#endif
+
+// ---------------------------------------------------------------------------
+// Fixtures
+
+static Scene* scene;
+static uint64_t seed = 1;
+static int team_size = PLAYER_COUNT;
+static struct Vec2 vecs[VEC_COUNT];
+static volatile float sink;     // keeps results alive so loops aren't optimized away
+
+static void fixed_scene(int size) {
+    if (size <= 0) size = team_size;
+    if (!scene || scene->team_size != size) {
+        scene_destroy(scene);
+        scene = scene_create(size, seed, 0);
+        if (!scene) {
+            fprintf(stderr, "out of memory\n");
+            exit(1);
+        }
+    }
+    scene_reset(scene, seed);
+    for (int i = 0; i < WARM_TICKS; i++)
+        update_scene(scene, 1.0f / SIM_TICK_RATE);
+    perception_update(scene);
+    player_block_gather(&scene->players);
+}
+
+static void fixed_vectors(void) {
+    for (int i = 0; i < VEC_COUNT; i++) {
+        // a spread of lengths and directions, no zeros
+        const float angle = (float)i * 0.618f;
+        const float length = 1.0f + (float)(i % 97) * 7.5f;
+        vecs[i].x = cosf(angle) * length;
+        vecs[i].y = sinf(angle) * length;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Benchmarks: each runs `n` operations
+
+static void bench_vec2_add(long n) {
+    struct Vec2 out = {0, 0};
+    for (long i = 0; i < n; i++)
+        vec2_add(&out, &out, &vecs[i & (VEC_COUNT - 1)]);
+    sink = out.x;
+}
+
+static void bench_vec2_sub(long n) {
+    struct Vec2 out = {0, 0};
+    for (long i = 0; i < n; i++)
+        vec2_sub(&out, &out, &vecs[i & (VEC_COUNT - 1)]);
+    sink = out.x;
+}
+
+static void bench_vec2_mul(long n) {
+    struct Vec2 out;
+    float acc = 0.0f;
+    for (long i = 0; i < n; i++) {
+        mulVec2(&out, &vecs[i & (VEC_COUNT - 1)], &vecs[(i + 1) & (VEC_COUNT - 1)]);
+        acc += out.x;
+    }
+    sink = acc;
+}
+
+static void bench_vec2_dot(long n) {
+    float acc = 0.0f;
+    for (long i = 0; i < n; i++)
+        acc += dotProduct(&vecs[i & (VEC_COUNT - 1)], &vecs[(i + 1) & (VEC_COUNT - 1)]);
+    sink = acc;
+}
+
+static void bench_vec2_determinant(long n) {
+    float acc = 0.0f;
+    for (long i = 0; i < n; i++)
+        acc += vec2Determinant(&vecs[i & (VEC_COUNT - 1)], &vecs[(i + 1) & (VEC_COUNT - 1)]);
+    sink = acc;
+}
+
+static void bench_vec2_length(long n) {
+    float acc = 0.0f;
+    for (long i = 0; i < n; i++)
+        acc += lengthVec2(&vecs[i & (VEC_COUNT - 1)]);
+    sink = acc;
+}
+
+static void bench_vec2_rotation(long n) {
+    float acc = 0.0f;
+    for (long i = 0; i < n; i++)
+        acc += vec2Rotation(&vecs[i & (VEC_COUNT - 1)]);
+    sink = acc;
+}
+
+static void bench_vec2_segment_distance(long n) {
+    float acc = 0.0f;
+    for (long i = 0; i < n; i++)
+        acc += vec2SegmentDistance(&vecs[i & (VEC_COUNT - 1)], &vecs[(i + 1) & (VEC_COUNT - 1)],
+                                   &vecs[(i + 2) & (VEC_COUNT - 1)]);
+    sink = acc;
+}
+
+// flights of up to ~300 px, from all over the window and a bit beyond
+static void bench_sweep_ball(long n) {
+    int acc = 0;
+    for (long i = 0; i < n; i++) {
+        const struct Vec2 p = vecs[i & (VEC_COUNT - 1)];
+        const struct Vec2 d = vecs[(i + 1) & (VEC_COUNT - 1)];
+        const struct Vec2 from = {CENTER_X + p.x * 0.7f, CENTER_Y + p.y * 0.5f};
+        const struct Vec2 to = {from.x + d.x * 0.4f, from.y + d.y * 0.4f};
+        acc += sweep_ball(from, to, BALL_RADIUS).kind;
+    }
+    sink = (float)acc;
+}
+
+static void bench_update_team(long n) {
+    for (long i = 0; i < n; i++)
+        update_team(scene, (i & 1) ? scene->second_team : scene->first_team);
+}
+
+static void bench_update_ball_possessor(long n) {
+    for (long i = 0; i < n; i++)
+        update_ball_possessor(scene);
+}
+
+static void bench_tackle(long n) {
+    // always contested: the two players take the ball off each other
+    struct Player* a = scene->first_team->players[0];
+    struct Player* b = scene->second_team->players[0];
+    scene->ball->possessor = a;
+    for (long i = 0; i < n; i++)
+        tackle(scene, scene->ball->possessor == a ? b : a);
+}
+
+static void bench_scene_states(long n) {
+    for (long i = 0; i < n; i++)
+        update_and_verify_scene_states(scene, 1.0f / SIM_TICK_RATE);
+}
+
+static void bench_update_scene(long n) {
+    for (long i = 0; i < n; i++) {
+        update_scene(scene, 1.0f / SIM_TICK_RATE);
+        if (scene->state == STATE_TIMEOUT)
+            scene_reset(scene, seed);   // rare; keeps every tick a real one
+    }
+}
+
+static void bench_perception_update(long n) {
+    for (long i = 0; i < n; i++)
+        perception_update(scene);
+}
+
+static void bench_passing_rank(long n) {
+    static struct PassOption options[MAX_TEAM_SIZE];
+    for (long i = 0; i < n; i++) {
+        const struct Player* carrier = scene->first_team->players[i % scene->team_size];
+        sink = (float)passing_rank(scene, carrier, options, MAX_TEAM_SIZE);
+    }
+}
+
+// brute force and grid, same work: 12, 22 and 200 players
+static void bench_separate_pairs(long n) {
+    for (long i = 0; i < n; i++)
+        player_block_separate(&scene->players, NULL);
+}
+
+static void bench_separate_grid(long n) {
+    struct PlayerBlock* block = &scene->players;
+    for (long i = 0; i < n; i++) {
+        spatial_grid_build(&scene->grid, block->x, block->y, block->view, 0, block->count);
+        player_block_separate(block, &scene->grid);
+    }
+}
+
+static void bench_nearest_pairs(long n) {
+    const struct PlayerBlock* block = &scene->players;
+    const int count = block->count, half = count / 2;
+    for (long k = 0; k < n; k++) {
+        // what perception does for small teams
+        for (int i = 0; i < count; i++) {
+            int best_mate = -1, best_opp = -1;
+            float mate_d = INFINITY, opp_d = INFINITY;
+            for (int j = 0; j < count; j++) {
+                if (j == i) continue;
+                const float dx = block->x[j] - block->x[i];
+                const float dy = block->y[j] - block->y[i];
+                const float d = dx * dx + dy * dy;
+                if ((j < half) == (i < half)) {
+                    if (d < mate_d) { mate_d = d; best_mate = j; }
+                } else {
+                    if (d < opp_d) { opp_d = d; best_opp = j; }
+                }
+            }
+            sink = (float)(best_mate + best_opp);
+        }
+    }
+}
+
+static void bench_nearest_grid(long n) {
+    const struct PlayerBlock* block = &scene->players;
+    const int count = block->count, half = count / 2;
+    for (long k = 0; k < n; k++) {
+        // what perception does for big teams
+        struct SpatialGrid* teams = scene->perception.team_grid;
+        spatial_grid_build(&teams[0], block->x, block->y, block->view, 0, half);
+        spatial_grid_build(&teams[1], block->x, block->y, block->view, half, count);
+        for (int i = 0; i < count; i++) {
+            const int best_mate = spatial_grid_nearest(&teams[i < half ? 0 : 1], block->x, block->y, i);
+            const int best_opp = spatial_grid_nearest(&teams[i < half ? 1 : 0], block->x, block->y, i);
+            sink = (float)(best_mate + best_opp);
+        }
+    }
+}
+
+static void bench_verify_talents(long n) {
+    for (long i = 0; i < n; i++)
+        verify_talents(scene->first_team->players[i % scene->team_size]->talents);
+}
+
+static void bench_verify_state(long n) {
+    for (long i = 0; i < n; i++)
+        verify_state(scene->first_team->players[i % scene->team_size], scene);
+}
+
+static void bench_verify_movement(long n) {
+    for (long i = 0; i < n; i++)
+        verify_movement(scene->first_team->players[i % scene->team_size]);
+}
+
+static void bench_verify_shoot(long n) {
+    for (long i = 0; i < n; i++)
+        verify_shoot(scene->ball, (i & 1) != 0);
+}
+
+static void bench_set_piece_out(long n) {
+    for (long i = 0; i < n; i++) {
+        // alternate sides, so both corners and goal kicks are taken
+        scene->ball->position.x = (i & 1) ? -20.0f : SCREEN_WIDTH + 20.0f;
+        scene->ball->position.y = (i & 2) ? 40.0f : SCREEN_HEIGHT - 40.0f;
+        scene->ball->last_team = 1 + (int)(i & 1);
+        set_piece_out(scene);
+    }
+}
+
+static void bench_set_piece_goal(long n) {
+    for (long i = 0; i < n; i++) {
+        scene->ball->position.x = (i & 1) ? CENTER_X - 300.0f : CENTER_X + 300.0f;
+        set_piece_goal(scene);
+    }
+}
+
+struct Benchmark {
+    const char* name;
+    void (*run)(long n);
+    int needs_scene;
+    int team_size;      /**< Players per team for this one; 0 means --team-size. */
+};
+
+static const struct Benchmark benchmarks[] = {
+    {"vec2/add", bench_vec2_add, 0, 0},
+    {"vec2/sub", bench_vec2_sub, 0, 0},
+    {"vec2/mul", bench_vec2_mul, 0, 0},
+    {"vec2/dot", bench_vec2_dot, 0, 0},
+    {"vec2/determinant", bench_vec2_determinant, 0, 0},
+    {"vec2/length", bench_vec2_length, 0, 0},
+    {"vec2/rotation", bench_vec2_rotation, 0, 0},
+    {"vec2/segment_distance", bench_vec2_segment_distance, 0, 0},
+    {"sweep/ball", bench_sweep_ball, 0, 0},
+    {"team/update_team", bench_update_team, 1, 0},
+    {"possession/update_ball_possessor", bench_update_ball_possessor, 1, 0},
+    {"possession/tackle", bench_tackle, 1, 0},
+    {"passing/rank", bench_passing_rank, 1, 0},
+    {"scene/update_and_verify_scene_states", bench_scene_states, 1, 0},
+    {"scene/update_scene", bench_update_scene, 1, 0},
+    {"referee/verify_talents", bench_verify_talents, 1, 0},
+    {"referee/verify_state", bench_verify_state, 1, 0},
+    {"referee/verify_movement", bench_verify_movement, 1, 0},
+    {"referee/verify_shoot", bench_verify_shoot, 1, 0},
+    {"set_piece/out", bench_set_piece_out, 1, 0},
+    {"set_piece/goal", bench_set_piece_goal, 1, 0},
+    {"grid/separate_pairs/12", bench_separate_pairs, 1, 6},
+    {"grid/separate_grid/12", bench_separate_grid, 1, 6},
+    {"grid/separate_pairs/22", bench_separate_pairs, 1, 11},
+    {"grid/separate_grid/22", bench_separate_grid, 1, 11},
+    {"grid/separate_pairs/200", bench_separate_pairs, 1, 100},
+    {"grid/separate_grid/200", bench_separate_grid, 1, 100},
+    {"grid/nearest_pairs/12", bench_nearest_pairs, 1, 6},
+    {"grid/nearest_grid/12", bench_nearest_grid, 1, 6},
+    {"grid/nearest_pairs/22", bench_nearest_pairs, 1, 11},
+    {"grid/nearest_grid/22", bench_nearest_grid, 1, 11},
+    {"grid/nearest_pairs/200", bench_nearest_pairs, 1, 100},
+    {"grid/nearest_grid/200", bench_nearest_grid, 1, 100},
+    {"scaling/perception_update/5v5", bench_perception_update, 1, 5},
+    {"scaling/perception_update/11v11", bench_perception_update, 1, 11},
+    {"scaling/perception_update/100v100", bench_perception_update, 1, 100},
+    {"scaling/passing_rank/5v5", bench_passing_rank, 1, 5},
+    {"scaling/passing_rank/11v11", bench_passing_rank, 1, 11},
+    {"scaling/passing_rank/100v100", bench_passing_rank, 1, 100},
+    {"scaling/update_scene/5v5", bench_update_scene, 1, 5},
+    {"scaling/update_scene/11v11", bench_update_scene, 1, 11},
+    {"scaling/update_scene/100v100", bench_update_scene, 1, 100},
+};
+
+int main(int argc, char** argv) {
+    const char* filter = NULL;
+    double min_time = 0.2;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+            filter = argv[++i];
+        else if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc)
+            min_time = atof(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            seed = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--team-size") == 0 && i + 1 < argc)
+            team_size = atoi(argv[++i]);
+    }
+    if (team_size < 1 || team_size > MAX_TEAM_SIZE) {
+        fprintf(stderr, "--team-size must be between 1 and %d\n", MAX_TEAM_SIZE);
+        return 1;
+    }
+    fixed_vectors();
+
+    printf("{\n  \"seed\": %llu,\n  \"warm_ticks\": %d,\n  \"tick_rate\": %d,\n  \"team_size\": %d,\n"
+           "  \"count_allocations\": %s,\n  \"benchmarks\": [",
+           (unsigned long long)seed, WARM_TICKS, SIM_TICK_RATE, team_size,
+#ifdef BENCH_COUNT_ALLOCS
+           "true"
+#else
+           "false"
+#endif
+    );
+
+    int printed = 0;
+    const int count = (int)(sizeof(benchmarks) / sizeof(benchmarks[0]));
+    for (int b = 0; b < count; b++) {
+        const struct Benchmark* bench = &benchmarks[b];
+        if (filter && !strstr(bench->name, filter))
+            continue;
+
+        // grow the batch until one batch takes at least min_time
+        long n = 1;
+        double seconds = 0.0;
+        unsigned long long allocs = 0;
+        for (;;) {
+            if (bench->needs_scene)
+                fixed_scene(bench->team_size);
+            const unsigned long long allocs_before = allocation_count();
+            const uint64_t start = clock_now_ns();
+            bench->run(n);
+            seconds = (double)(clock_now_ns() - start) / 1e9;
+            allocs = allocation_count() - allocs_before;
+            if (seconds >= min_time || n >= (1L << 40))
+                break;
+            // aim a bit past min_time, but never more than 100x per step
+            const double grow = seconds > 0.0 ? 1.2 * min_time / seconds : 100.0;
+            n = (long)((double)n * (grow < 2.0 ? 2.0 : grow > 100.0 ? 100.0 : grow));
+        }
+
+        printf("%s\n    {\"name\": \"%s\", \"iterations\": %ld, \"ns_per_op\": %.3f, \"allocs_per_op\": ",
+               printed++ ? "," : "", bench->name, n, seconds * 1e9 / (double)n);
+#ifdef BENCH_COUNT_ALLOCS
+        printf("%.4f}", (double)allocs / (double)n);
+#else
+        (void)allocs;
+        printf("-1}");
+#endif
+        fflush(stdout);
+    }
+    printf("\n  ]\n}\n");
+
+    scene_destroy(scene);
+    return 0;
+}
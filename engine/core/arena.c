@@ -0,0 +1,27 @@
+#include "arena.h"
+
+#include <stdint.h>
+
+void arena_init(struct Arena *arena, void *memory, size_t size) {
+  arena->base = memory;
+  arena->size = size;
+  arena->used = 0;
+}
+
+void *arena_alloc(struct Arena *arena, size_t size, size_t align) {
+  // align the address, not just the offset, in case base itself isn't aligned
+  uintptr_t start = (uintptr_t)(arena->base + arena->used);
+  uintptr_t aligned = (start + align - 1) & ~(uintptr_t)(align - 1);
+  size_t offset = arena->used + (size_t)(aligned - start);
+
+  if (offset > arena->size || size > arena->size - offset)
+    return NULL;
+
+  arena->used = offset + size;
+  return arena->base + offset;
+}
+
+void arena_reset(struct Arena *arena, size_t mark) {
+  if (mark < arena->used)
+    arena->used = mark;
+}
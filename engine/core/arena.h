@@ -0,0 +1,50 @@
+/**
+ * @file arena.h
+ * @brief Bump allocator over one contiguous block of memory.
+ * * Allocation is a pointer increment; there is no per-object free. Everything
+ * carved out of an arena goes away at once, either with arena_reset() (keep
+ * the memory for reuse) or by freeing the block the arena wraps.
+ */
+
+#ifndef ENGINE_CORE_ARENA_H
+#define ENGINE_CORE_ARENA_H
+
+#include <stddef.h>
+
+/** Alignment used when the caller doesn't care; enough for any scalar or SSE type. */
+#define ARENA_DEFAULT_ALIGN 16
+
+/**
+ * @struct Arena
+ * @brief A fixed-size block and how much of it is in use.
+ */
+struct Arena {
+    unsigned char* base;
+    size_t size;
+    size_t used;
+};
+
+/**
+ * @brief Rounds `size` up to the next multiple of `align` (a power of two).
+ */
+static inline size_t arena_align_up(size_t size, size_t align) {
+    return (size + align - 1) & ~(align - 1);
+}
+
+/**
+ * @brief Wraps caller-owned memory. The arena never frees it.
+ */
+void arena_init(struct Arena* arena, void* memory, size_t size);
+
+/**
+ * @brief Carves `size` bytes aligned to `align` out of the arena.
+ * @return NULL if the arena is full.
+ */
+void* arena_alloc(struct Arena* arena, size_t size, size_t align);
+
+/**
+ * @brief Forgets every allocation made after `mark` (a previous `used` value).
+ */
+void arena_reset(struct Arena* arena, size_t mark);
+
+#endif
@@ -0,0 +1,30 @@
+/**
+ * @file atomic.h
+ * @brief The few atomic operations the lock-free structures need.
+ * * Thin wrappers over the GCC / Clang __atomic builtins (the project is C99,
+ * so <stdatomic.h> is off the table). Only plain integers and pointers go
+ * through these; the memory order is part of the name so every use says
+ * what it synchronizes with.
+ */
+
+#ifndef ENGINE_CORE_ATOMIC_H
+#define ENGINE_CORE_ATOMIC_H
+
+#define load_relaxed(p)         __atomic_load_n((p), __ATOMIC_RELAXED)
+#define load_acquire(p)         __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define store_relaxed(p, v)     __atomic_store_n((p), (v), __ATOMIC_RELAXED)
+#define store_release(p, v)     __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define fetch_add_relaxed(p, v) __atomic_fetch_add((p), (v), __ATOMIC_RELAXED)
+#define exchange_acq_rel(p, v)  __atomic_exchange_n((p), (v), __ATOMIC_ACQ_REL)
+
+/** @brief If *p == *expected, sets *p = v; otherwise loads *p into *expected. May fail spuriously. */
+#define cas_weak_relaxed(p, expected, v) \
+  __atomic_compare_exchange_n((p), (expected), (v), 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)
+
+/** @brief Size to pad shared counters to, so two threads never write the same line. */
+#define CACHE_LINE 64
+
+/** @brief Storage class for per-thread variables. */
+#define THREAD_LOCAL __thread
+
+#endif
@@ -0,0 +1,22 @@
+/**
+ * @file clock.h
+ * @brief Monotonic wall clock without any SDL dependency.
+ * * The headless tools use this instead of SDL_GetTicks to measure how
+ * long a match took to simulate.
+ */
+
+#ifndef ENGINE_CORE_CLOCK_H
+#define ENGINE_CORE_CLOCK_H
+
+#include <stdint.h>
+
+/**
+ * @brief Returns a monotonic timestamp in seconds.
+ * Only differences between two calls are meaningful.
+ */
+double clock_now_seconds(void);
+
+/** @brief Same clock in nanoseconds, for timing short stretches of code. */
+uint64_t clock_now_ns(void);
+
+#endif
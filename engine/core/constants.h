@@ -17,7 +17,8 @@
 // --- Entity Physics ---
 #define BALL_RADIUS 10.0f
 #define PLAYER_RADIUS 16.0f
-#define PLAYER_COUNT 6
+#define PLAYER_COUNT 6      /**< Default players per team, and the size of the coach's tables. */
+#define MAX_TEAM_SIZE 255   /**< Largest team a scene can hold (kits fit in a byte). */
 
 #define MAX_TALENT_PER_PLAYER 20
 #define MAX_TALENT_PER_SKILL 10
@@ -25,9 +26,15 @@
 #define MAX_BALL_VELOCITY 350.0f
 
 /** * @brief Ball friction coefficient. 
- * Multiplied by velocity every frame; 1.0 is no friction, 0.0 is an immediate stop.
+ * Multiplied by velocity once per 1/FRICTION_REFERENCE_RATE seconds; 1.0 is no
+ * friction, 0.0 is an immediate stop. Other tick rates scale it so the ball
+ * slows down at the same speed regardless of how often the scene is updated.
  */
 #define FRICTION 0.98f
+#define FRICTION_REFERENCE_RATE 60.0f
+
+// --- Simulation Clock ---
+#define SIM_TICK_RATE 60    /**< Default fixed simulation ticks per second. */
 
 // --- Pitch & UI Layout ---
 #define SCREEN_WIDTH 1000
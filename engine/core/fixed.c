@@ -0,0 +1,52 @@
+#include "fixed.h"
+
+uint32_t fixed_isqrt64(uint64_t v) {
+  // one result bit per step, from the top
+  uint64_t root = 0;
+  uint64_t bit = (uint64_t)1 << 62;
+  while (bit > v)
+    bit >>= 2;
+  while (bit != 0) {
+    if (v >= root + bit) {
+      v -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return (uint32_t)root;
+}
+
+fixed fixed_sqrt(fixed a) {
+  if (a <= 0)
+    return 0;
+  return (fixed)fixed_isqrt64((uint64_t)a << FIXED_SHIFT);
+}
+
+fixed fixed_hypot(fixed x, fixed y) {
+  // sqrt of a Q32.32 value is Q16.16; saturate instead of wrapping
+  const uint32_t root = fixed_isqrt64(fixed_length_sq(x, y));
+  return root > (uint32_t)INT32_MAX ? INT32_MAX : (fixed)root;
+}
+
+fixed fixed_pow(fixed base, fixed exponent) {
+  fixed result = FIXED_ONE;
+
+  // integer part: base^n by squaring
+  fixed square = base;
+  for (int32_t n = exponent >> FIXED_SHIFT; n > 0; n >>= 1) {
+    if (n & 1)
+      result = fixed_mul(result, square);
+    square = fixed_mul(square, square);
+  }
+
+  // fraction: base^(1/2), base^(1/4), ... for each bit that is set
+  fixed root = base;
+  for (int bit = FIXED_SHIFT - 1; bit >= 0; bit--) {
+    root = fixed_sqrt(root);
+    if (exponent & ((fixed)1 << bit))
+      result = fixed_mul(result, root);
+  }
+  return result;
+}
@@ -0,0 +1,114 @@
+/**
+ * @file fixed.h
+ * @brief Q16.16 fixed-point numbers, for physics that is bit-identical everywhere.
+ * * Float results depend on the compiler, its flags and the CPU: whether
+ * a * b + c is fused into one instruction, which libm computes hypotf or
+ * powf. Integer arithmetic doesn't. Builds configured with
+ * -DSOCCER_FIXED_POINT=ON (which defines SOCCER_FIXED_POINT) run
+ * integration, friction and collisions through these functions. The
+ * entities keep their float fields: values are converted on the way in and
+ * out, and conversions between float and fixed are exact or correctly
+ * rounded on every IEEE platform.
+ *
+ * A fixed holds value * 65536 in an int32_t: 1/65536 px resolution, range
+ * +-32768. Products of two coordinates can exceed that; they are kept as
+ * 64-bit Q32.32 values (see fixed_hypot).
+ *
+ * Right shifts of negative values are assumed to be arithmetic, as they
+ * are with GCC, Clang and MSVC.
+ */
+
+#ifndef ENGINE_CORE_FIXED_H
+#define ENGINE_CORE_FIXED_H
+
+#include "vec2.h"
+
+#include <stdint.h>
+
+typedef int32_t fixed;
+
+#define FIXED_SHIFT 16
+#define FIXED_ONE ((fixed)1 << FIXED_SHIFT)
+
+/**
+ * @brief Nearest fixed to `f`, halves away from zero.
+ * Values outside the range (|f| >= 32768) saturate to INT32_MIN / INT32_MAX,
+ * NaN gives 0: converting those to an integer directly is undefined.
+ */
+static inline fixed fixed_from_float(float f) {
+    // a plain cast truncates in one instruction; floorf may be a libm call
+    const float scaled = f * (float)FIXED_ONE;
+    if (scaled >= 2147483648.0f) return INT32_MAX;
+    if (scaled <= -2147483648.0f) return INT32_MIN;
+    if (scaled != scaled) return 0;
+    return (fixed)(scaled + (scaled < 0.0f ? -0.5f : 0.5f));
+}
+
+static inline float fixed_to_float(fixed a) {
+    return (float)a / (float)FIXED_ONE;
+}
+
+/** @brief a * b, rounded to nearest. */
+static inline fixed fixed_mul(fixed a, fixed b) {
+    return (fixed)(((int64_t)a * b + (FIXED_ONE >> 1)) >> FIXED_SHIFT);
+}
+
+/** @brief a / b, rounded towards zero; b must not be 0. */
+static inline fixed fixed_div(fixed a, fixed b) {
+    return (fixed)((int64_t)a * FIXED_ONE / b);
+}
+
+/** @brief x * x + y * y as Q32.32; can't overflow. */
+static inline uint64_t fixed_length_sq(fixed x, fixed y) {
+    return (uint64_t)((int64_t)x * x) + (uint64_t)((int64_t)y * y);
+}
+
+/** @brief floor(sqrt(v)) for any 64-bit v. */
+uint32_t fixed_isqrt64(uint64_t v);
+
+/** @brief sqrt(a); 0 for a <= 0. */
+fixed fixed_sqrt(fixed a);
+
+/** @brief sqrt(x * x + y * y), without overflowing in between. */
+fixed fixed_hypot(fixed x, fixed y);
+
+/**
+ * @brief base ^ exponent for base > 0 and exponent >= 0: repeated squaring
+ * for the integer part, a chain of square roots for the fraction.
+ */
+fixed fixed_pow(fixed base, fixed exponent);
+
+/**
+ * @struct FixedVec2
+ * @brief A Vec2 in fixed point.
+ */
+struct FixedVec2 {
+    fixed x;
+    fixed y;
+};
+
+static inline struct FixedVec2 fvec2_from(struct Vec2 v) {
+    return (struct FixedVec2){fixed_from_float(v.x), fixed_from_float(v.y)};
+}
+
+static inline struct Vec2 fvec2_to(struct FixedVec2 v) {
+    return (struct Vec2){fixed_to_float(v.x), fixed_to_float(v.y)};
+}
+
+static inline struct FixedVec2 fvec2_add(struct FixedVec2 a, struct FixedVec2 b) {
+    return (struct FixedVec2){a.x + b.x, a.y + b.y};
+}
+
+static inline struct FixedVec2 fvec2_sub(struct FixedVec2 a, struct FixedVec2 b) {
+    return (struct FixedVec2){a.x - b.x, a.y - b.y};
+}
+
+static inline struct FixedVec2 fvec2_scale(struct FixedVec2 v, fixed s) {
+    return (struct FixedVec2){fixed_mul(v.x, s), fixed_mul(v.y, s)};
+}
+
+static inline fixed fvec2_length(struct FixedVec2 v) {
+    return fixed_hypot(v.x, v.y);
+}
+
+#endif
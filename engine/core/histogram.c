@@ -0,0 +1,77 @@
+#include "histogram.h"
+
+#include <string.h>
+
+#define SUB_COUNT (1u << HISTOGRAM_SUB_BITS)
+
+static int bucket_index(uint64_t v) {
+  if (v < SUB_COUNT)
+    return (int)v;  // exact
+  int e = 63 - __builtin_clzll(v);  // v is in [2^e, 2^(e+1))
+  if (e > HISTOGRAM_MAX_BITS) {
+    e = HISTOGRAM_MAX_BITS;
+    v = (2ull << e) - 1;
+  }
+  const int shift = e - HISTOGRAM_SUB_BITS;
+  // top SUB_BITS + 1 bits of v, in [SUB_COUNT, 2 * SUB_COUNT)
+  const int mantissa = (int)(v >> shift);
+  return (shift + 1) * (int)SUB_COUNT + mantissa - (int)SUB_COUNT;
+}
+
+// Largest value that lands in bucket `i`
+static uint64_t bucket_top(int i) {
+  if (i < (int)SUB_COUNT)
+    return (uint64_t)i;
+  const int shift = i / (int)SUB_COUNT - 1;
+  const uint64_t mantissa = (uint64_t)(i % (int)SUB_COUNT) + SUB_COUNT;
+  return ((mantissa + 1) << shift) - 1;
+}
+
+void histogram_reset(struct Histogram *h) {
+  memset(h, 0, sizeof(*h));
+}
+
+void histogram_record(struct Histogram *h, uint64_t value) {
+  if (h->count == 0 || value < h->min) h->min = value;
+  if (value > h->max) h->max = value;
+  h->count++;
+  h->sum += value;
+  h->bucket[bucket_index(value)]++;
+}
+
+void histogram_merge(struct Histogram *into, const struct Histogram *from) {
+  if (from->count == 0)
+    return;
+  if (into->count == 0 || from->min < into->min) into->min = from->min;
+  if (from->max > into->max) into->max = from->max;
+  into->count += from->count;
+  into->sum += from->sum;
+  for (int i = 0; i < HISTOGRAM_BUCKETS; i++)
+    into->bucket[i] += from->bucket[i];
+}
+
+uint64_t histogram_percentile(const struct Histogram *h, double percent) {
+  if (h->count == 0)
+    return 0;
+  if (percent <= 0.0)
+    return h->min;
+  // smallest bucket with at least `rank` values at or below it
+  uint64_t rank = (uint64_t)(percent / 100.0 * (double)h->count + 0.5);
+  if (rank < 1) rank = 1;
+  if (rank > h->count) rank = h->count;
+  uint64_t seen = 0;
+  for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+    seen += h->bucket[i];
+    if (seen >= rank) {
+      if (i == HISTOGRAM_BUCKETS - 1)
+        return h->max;  // the overflow bucket has no top
+      const uint64_t top = bucket_top(i);
+      return top < h->max ? top : h->max;
+    }
+  }
+  return h->max;
+}
+
+double histogram_mean(const struct Histogram *h) {
+  return h->count ? (double)h->sum / (double)h->count : 0.0;
+}
@@ -0,0 +1,48 @@
+/**
+ * @file histogram.h
+ * @brief Fixed-size latency histogram with bounded relative error (HDR style).
+ * * Values below 2^HISTOGRAM_SUB_BITS are counted exactly; above that, every
+ * power of two is split into 2^HISTOGRAM_SUB_BITS equal buckets, so any
+ * value (and any percentile) is known to within about 3%, from nanoseconds
+ * up to minutes, in a few kilobytes. Recording is an index computation and
+ * an increment: cheap enough to do around every phase of every tick.
+ */
+
+#ifndef ENGINE_CORE_HISTOGRAM_H
+#define ENGINE_CORE_HISTOGRAM_H
+
+#include <stdint.h>
+
+#define HISTOGRAM_SUB_BITS 5    /**< 32 buckets per power of two. */
+#define HISTOGRAM_MAX_BITS 40   /**< Largest value kept apart: 2^40 (about 18 minutes in ns). */
+#define HISTOGRAM_BUCKETS ((HISTOGRAM_MAX_BITS - HISTOGRAM_SUB_BITS + 2) << HISTOGRAM_SUB_BITS)
+
+/**
+ * @struct Histogram
+ * @brief Zero-initialized (or histogram_reset) means empty.
+ */
+struct Histogram {
+    uint64_t count;
+    uint64_t sum;
+    uint64_t min;   /**< Exact, valid when count > 0. */
+    uint64_t max;   /**< Exact. */
+    uint64_t bucket[HISTOGRAM_BUCKETS];
+};
+
+void histogram_reset(struct Histogram* h);
+
+/** @brief Counts one value. Values past 2^HISTOGRAM_MAX_BITS land in the last bucket. */
+void histogram_record(struct Histogram* h, uint64_t value);
+
+/** @brief Adds everything counted in `from` to `into`. */
+void histogram_merge(struct Histogram* into, const struct Histogram* from);
+
+/**
+ * @brief The value below which `percent`% of the counted values fall
+ * (the top of its bucket, never above max). 0 for an empty histogram.
+ */
+uint64_t histogram_percentile(const struct Histogram* h, double percent);
+
+double histogram_mean(const struct Histogram* h);
+
+#endif
@@ -0,0 +1,462 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "log.h"
+#include "atomic.h"
+#include "clock.h"
+
+#include <ctype.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define LOG_QUEUE_SIZE 1024     // records; must be a power of two
+#define LOG_ARG_BYTES 200       // argument values (and copied strings) per record
+#define LOG_LINE_BYTES 512
+
+static const char *level_names[] = {"trace", "debug", "info", "warn", "error", "off"};
+static const char *module_names[LOG_MODULE_COUNT] = {"core", "scene", "referee", "match", "replay", "render"};
+
+static int module_level[LOG_MODULE_COUNT] = {    // one per LogModule
+  LOG_LEVEL_INFO, LOG_LEVEL_INFO, LOG_LEVEL_INFO, LOG_LEVEL_INFO, LOG_LEVEL_INFO, LOG_LEVEL_INFO,
+};
+
+struct LogRecord {
+  size_t seq;               // queue bookkeeping, see below
+  unsigned char level;
+  unsigned char module;
+  unsigned char truncated;  // arguments ran out of room after `used` bytes
+  unsigned short used;
+  double time;
+  const char *format;
+  unsigned char args[LOG_ARG_BYTES];
+};
+
+// Bounded MPMC queue (D. Vyukov's): a cell is free for the producer that
+// claimed position `pos` when its seq == pos, and holds a record for the
+// consumer at `pos` when seq == pos + 1.
+static struct {
+  struct LogRecord cell[LOG_QUEUE_SIZE];
+  unsigned char pad0[CACHE_LINE];
+  size_t enqueue_pos;
+  unsigned char pad1[CACHE_LINE - sizeof(size_t)];
+  size_t dequeue_pos;
+  unsigned char pad2[CACHE_LINE - sizeof(size_t)];
+} queue;
+
+static FILE *log_out;
+static double epoch;
+static int running;         // the writer thread is up and owns the queue
+static int stopping;
+static size_t flushed;      // records written and flushed by the writer
+static unsigned long dropped;
+static pthread_t writer;
+
+bool log_enabled(int level, LogModule module) {
+  return level >= load_relaxed(&module_level[module]);
+}
+
+void log_set_level(LogModule module, int level) {
+  if (module >= 0 && module < LOG_MODULE_COUNT)
+    store_relaxed(&module_level[module], level);
+}
+
+unsigned long log_dropped(void) {
+  return load_relaxed(&dropped);
+}
+
+// ---------------------------------------------------------------------------
+// Conversion specs. Both sides walk the format the same way: the caller to
+// know which va_arg to take, the writer to know how to print what was taken.
+
+struct Spec {
+  char flags[8];
+  int width, precision;     // -1: not given; -2: '*', taken from the arguments
+  char length;              // 'H' hh, 'h', 'l', 'q' ll, 'j', 'z', 't', 'L', or 0
+  char conv;
+};
+
+static const char *parse_spec(const char *p, struct Spec *s) {
+  int n = 0;
+  while (*p && strchr("-+ #0", *p) && n < (int)sizeof(s->flags) - 1)
+    s->flags[n++] = *p++;
+  s->flags[n] = '\0';
+
+  s->width = -1;
+  if (*p == '*') { s->width = -2; p++; }
+  else if (isdigit((unsigned char)*p)) s->width = (int)strtol(p, (char **)&p, 10);
+
+  s->precision = -1;
+  if (*p == '.') {
+    p++;
+    if (*p == '*') { s->precision = -2; p++; }
+    else s->precision = (int)strtol(p, (char **)&p, 10);
+  }
+
+  s->length = 0;
+  switch (*p) {
+    case 'h': s->length = p[1] == 'h' ? 'H' : 'h'; p += p[1] == 'h' ? 2 : 1; break;
+    case 'l': s->length = p[1] == 'l' ? 'q' : 'l'; p += p[1] == 'l' ? 2 : 1; break;
+    case 'j': case 'z': case 't': case 'L': s->length = *p++; break;
+    default: break;
+  }
+  s->conv = *p ? *p++ : '\0';
+  return p;
+}
+
+static bool is_int_conv(char c) { return c && strchr("diouxXc", c); }
+static bool is_float_conv(char c) { return c && strchr("fFeEgGaA", c); }
+
+// ---------------------------------------------------------------------------
+// Caller side: copy the arguments
+
+static bool put(struct LogRecord *r, const void *value, size_t size) {
+  if (r->used + size > LOG_ARG_BYTES) {
+    r->truncated = 1;
+    return false;
+  }
+  memcpy(r->args + r->used, value, size);
+  r->used += (unsigned short)size;
+  return true;
+}
+
+static void capture(struct LogRecord *r, const char *format, va_list ap) {
+  r->used = 0;
+  r->truncated = 0;
+  for (const char *p = format; *p;) {
+    if (*p++ != '%') continue;
+    if (*p == '%') { p++; continue; }
+
+    struct Spec s;
+    p = parse_spec(p, &s);
+    if (s.width == -2) { int w = va_arg(ap, int); if (!put(r, &w, sizeof(w))) return; }
+    if (s.precision == -2) { int pr = va_arg(ap, int); if (!put(r, &pr, sizeof(pr))) return; }
+
+    if (s.conv == 'd' || s.conv == 'i') {
+      intmax_t v;
+      switch (s.length) {
+        case 'H': v = (signed char)va_arg(ap, int); break;
+        case 'h': v = (short)va_arg(ap, int); break;
+        case 'l': v = va_arg(ap, long); break;
+        case 'q': v = va_arg(ap, long long); break;
+        case 'j': v = va_arg(ap, intmax_t); break;
+        case 'z': v = (intmax_t)va_arg(ap, size_t); break;
+        case 't': v = va_arg(ap, ptrdiff_t); break;
+        default:  v = va_arg(ap, int); break;
+      }
+      if (!put(r, &v, sizeof(v))) return;
+    } else if (is_int_conv(s.conv)) {
+      uintmax_t v;
+      switch (s.length) {
+        case 'H': v = (unsigned char)va_arg(ap, unsigned); break;
+        case 'h': v = (unsigned short)va_arg(ap, unsigned); break;
+        case 'l': v = va_arg(ap, unsigned long); break;
+        case 'q': v = va_arg(ap, unsigned long long); break;
+        case 'j': v = va_arg(ap, uintmax_t); break;
+        case 'z': v = va_arg(ap, size_t); break;
+        case 't': v = (uintmax_t)va_arg(ap, ptrdiff_t); break;
+        default:  v = s.conv == 'c' ? (uintmax_t)(unsigned char)va_arg(ap, int) : va_arg(ap, unsigned); break;
+      }
+      if (!put(r, &v, sizeof(v))) return;
+    } else if (is_float_conv(s.conv)) {
+      long double v = s.length == 'L' ? va_arg(ap, long double) : va_arg(ap, double);
+      if (!put(r, &v, sizeof(v))) return;
+    } else if (s.conv == 'p') {
+      void *v = va_arg(ap, void *);
+      if (!put(r, &v, sizeof(v))) return;
+    } else if (s.conv == 's') {
+      const char *v = va_arg(ap, const char *);
+      if (!v) v = "(null)";
+      // as much of the string as fits, always terminated
+      const size_t room = LOG_ARG_BYTES - r->used;
+      size_t len = strlen(v);
+      if (room == 0) { r->truncated = 1; return; }
+      if (len >= room) len = room - 1;
+      memcpy(r->args + r->used, v, len);
+      r->args[r->used + len] = '\0';
+      r->used += (unsigned short)(len + 1);
+    } else {
+      r->truncated = 1;     // %n or something we don't know: stop here
+      return;
+    }
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Writer side: print them
+
+static void take(const struct LogRecord *r, size_t *at, void *value, size_t size) {
+  memcpy(value, r->args + *at, size);
+  *at += size;
+}
+
+// Appends printf-style output at out[*n], never past cap
+static void append(char *out, size_t cap, size_t *n, const char *fmt, ...) {
+  if (*n >= cap) return;
+  va_list ap;
+  va_start(ap, fmt);
+  const int len = vsnprintf(out + *n, cap - *n, fmt, ap);
+  va_end(ap);
+  if (len > 0) *n = *n + (size_t)len < cap ? *n + (size_t)len : cap - 1;
+}
+
+static size_t render(const struct LogRecord *r, char *out, size_t cap) {
+  size_t n = 0;
+  size_t at = 0;
+  append(out, cap, &n, "[%9.3f] %-5s %s: ", r->time, level_names[r->level], module_names[r->module]);
+
+  for (const char *p = r->format; *p && n < cap - 1;) {
+    if (*p != '%') { out[n++] = *p++; continue; }
+    p++;
+    if (*p == '%') { out[n++] = *p++; continue; }
+
+    struct Spec s;
+    p = parse_spec(p, &s);
+    int width = s.width, precision = s.precision;
+    // ran out of captured arguments: the rest of the message is lost
+    const size_t need = (s.width == -2 ? sizeof(int) : 0) + (s.precision == -2 ? sizeof(int) : 0);
+    if (r->truncated && at + need >= r->used) {
+      append(out, cap, &n, "...");
+      break;
+    }
+    if (s.width == -2) take(r, &at, &width, sizeof(width));
+    if (s.precision == -2) take(r, &at, &precision, sizeof(precision));
+
+    // rebuild the spec with explicit numbers and our widened argument type
+    char spec[48];
+    size_t k = 0;
+    spec[k++] = '%';
+    k += (size_t)snprintf(spec + k, sizeof(spec) - k, "%s", s.flags);
+    if (s.width != -1)  // a negative '*' width means left-justified
+      k += (size_t)snprintf(spec + k, sizeof(spec) - k, width < 0 ? "-%d" : "%d", width < 0 ? -width : width);
+    if (precision >= 0) // and a negative '*' precision means none
+      k += (size_t)snprintf(spec + k, sizeof(spec) - k, ".%d", precision);
+
+    if (s.conv == 'd' || s.conv == 'i') {
+      intmax_t v;
+      take(r, &at, &v, sizeof(v));
+      snprintf(spec + k, sizeof(spec) - k, "j%c", s.conv);
+      append(out, cap, &n, spec, v);
+    } else if (s.conv == 'c') {
+      uintmax_t v;
+      take(r, &at, &v, sizeof(v));
+      snprintf(spec + k, sizeof(spec) - k, "c");
+      append(out, cap, &n, spec, (int)v);
+    } else if (is_int_conv(s.conv)) {
+      uintmax_t v;
+      take(r, &at, &v, sizeof(v));
+      snprintf(spec + k, sizeof(spec) - k, "j%c", s.conv);
+      append(out, cap, &n, spec, v);
+    } else if (is_float_conv(s.conv)) {
+      long double v;
+      take(r, &at, &v, sizeof(v));
+      snprintf(spec + k, sizeof(spec) - k, "L%c", s.conv);
+      append(out, cap, &n, spec, v);
+    } else if (s.conv == 'p') {
+      void *v;
+      take(r, &at, &v, sizeof(v));
+      snprintf(spec + k, sizeof(spec) - k, "p");
+      append(out, cap, &n, spec, v);
+    } else if (s.conv == 's') {
+      const char *v = (const char *)r->args + at;
+      at += strlen(v) + 1;
+      snprintf(spec + k, sizeof(spec) - k, "s");
+      append(out, cap, &n, spec, v);
+    } else {
+      append(out, cap, &n, "...");
+      break;
+    }
+  }
+  if (n > cap - 2) n = cap - 2;
+  out[n++] = '\n';
+  out[n] = '\0';
+  return n;
+}
+
+static void write_record(const struct LogRecord *r) {
+  char line[LOG_LINE_BYTES];
+  render(r, line, sizeof(line));
+  fputs(line, log_out ? log_out : stderr);
+}
+
+// ---------------------------------------------------------------------------
+// Queue
+
+static struct LogRecord *claim(size_t *pos_out) {
+  size_t pos = load_relaxed(&queue.enqueue_pos);
+  for (;;) {
+    struct LogRecord *cell = &queue.cell[pos & (LOG_QUEUE_SIZE - 1)];
+    const size_t seq = load_acquire(&cell->seq);
+    const intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+    if (diff == 0) {
+      if (cas_weak_relaxed(&queue.enqueue_pos, &pos, pos + 1)) {
+        *pos_out = pos;
+        return cell;
+      }
+    } else if (diff < 0) {
+      return NULL;  // full
+    } else {
+      pos = load_relaxed(&queue.enqueue_pos);
+    }
+  }
+}
+
+static struct LogRecord *next_record(size_t *pos_out) {
+  size_t pos = load_relaxed(&queue.dequeue_pos);
+  for (;;) {
+    struct LogRecord *cell = &queue.cell[pos & (LOG_QUEUE_SIZE - 1)];
+    const size_t seq = load_acquire(&cell->seq);
+    const intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+    if (diff == 0) {
+      if (cas_weak_relaxed(&queue.dequeue_pos, &pos, pos + 1)) {
+        *pos_out = pos;
+        return cell;
+      }
+    } else if (diff < 0) {
+      return NULL;  // empty
+    } else {
+      pos = load_relaxed(&queue.dequeue_pos);
+    }
+  }
+}
+
+void log_write(int level, LogModule module, const char *format, ...) {
+  va_list ap;
+  va_start(ap, format);
+
+  if (!load_acquire(&running)) {
+    // no writer thread: do it here
+    struct LogRecord r;
+    r.level = (unsigned char)level;
+    r.module = (unsigned char)module;
+    r.time = epoch > 0.0 ? clock_now_seconds() - epoch : 0.0;
+    r.format = format;
+    capture(&r, format, ap);
+    write_record(&r);
+    va_end(ap);
+    return;
+  }
+
+  size_t pos;
+  struct LogRecord *cell = claim(&pos);
+  if (!cell) {
+    fetch_add_relaxed(&dropped, 1ul);
+    va_end(ap);
+    return;
+  }
+  cell->level = (unsigned char)level;
+  cell->module = (unsigned char)module;
+  cell->time = clock_now_seconds() - epoch;
+  cell->format = format;
+  capture(cell, format, ap);
+  va_end(ap);
+  store_release(&cell->seq, pos + 1);
+}
+
+// Writes every queued record; returns how many
+static size_t drain(void) {
+  size_t pos, count = 0;
+  struct LogRecord *cell;
+  while ((cell = next_record(&pos)) != NULL) {
+    write_record(cell);
+    store_release(&cell->seq, pos + LOG_QUEUE_SIZE);
+    count++;
+  }
+  return count;
+}
+
+static void *writer_main(void *arg) {
+  (void)arg;
+  const struct timespec nap = {0, 1000000};   // 1 ms between empty polls
+  for (;;) {
+    const int stop = load_acquire(&stopping);
+    if (drain() == 0) {
+      fflush(log_out);
+      store_release(&flushed, load_relaxed(&queue.dequeue_pos));
+      if (stop)
+        break;
+      nanosleep(&nap, NULL);
+    }
+  }
+  return NULL;
+}
+
+bool log_start(FILE *out) {
+  if (load_acquire(&running))
+    return true;
+  log_out = out ? out : stderr;
+  epoch = clock_now_seconds();
+  for (size_t i = 0; i < LOG_QUEUE_SIZE; i++)
+    queue.cell[i].seq = i;
+  queue.enqueue_pos = 0;
+  queue.dequeue_pos = 0;
+  flushed = 0;
+  stopping = 0;
+  if (pthread_create(&writer, NULL, writer_main, NULL) != 0)
+    return false;
+  store_release(&running, 1);
+  return true;
+}
+
+void log_flush(void) {
+  if (!load_acquire(&running)) {
+    fflush(log_out ? log_out : stderr);
+    return;
+  }
+  const struct timespec nap = {0, 1000000};
+  const size_t target = load_acquire(&queue.enqueue_pos);
+  while (load_acquire(&flushed) < target)
+    nanosleep(&nap, NULL);
+}
+
+void log_stop(void) {
+  if (!load_acquire(&running))
+    return;
+  store_release(&stopping, 1);
+  pthread_join(writer, NULL);
+  store_release(&running, 0);
+  drain();  // anyone who slipped in while the writer was finishing
+  fflush(log_out);
+}
+
+// ---------------------------------------------------------------------------
+// Configuration
+
+static int find_name(const char *const *names, int count, const char *text, size_t len) {
+  for (int i = 0; i < count; i++) {
+    if (strlen(names[i]) == len && strncmp(names[i], text, len) == 0)
+      return i;
+  }
+  return -1;
+}
+
+bool log_configure(const char *spec) {
+  bool ok = true;
+  for (const char *p = spec; p && *p;) {
+    const char *end = strchr(p, ',');
+    const size_t len = end ? (size_t)(end - p) : strlen(p);
+    const char *eq = memchr(p, '=', len);
+
+    if (eq) {
+      const int module = find_name(module_names, LOG_MODULE_COUNT, p, (size_t)(eq - p));
+      const int level = find_name(level_names, LOG_LEVEL_OFF + 1, eq + 1, len - (size_t)(eq - p) - 1);
+      if (module >= 0 && level >= 0) log_set_level((LogModule)module, level);
+      else ok = false;
+    } else {
+      const int level = find_name(level_names, LOG_LEVEL_OFF + 1, p, len);
+      if (level >= 0) {
+        for (int m = 0; m < LOG_MODULE_COUNT; m++)
+          log_set_level((LogModule)m, level);
+      } else {
+        ok = false;
+      }
+    }
+    p = end ? end + 1 : NULL;
+  }
+  return ok;
+}
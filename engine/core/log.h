@@ -0,0 +1,123 @@
+/**
+ * @file log.h
+ * @brief Leveled, per-module logging, formatted on a background thread.
+ * * A LOG_*() call doesn't format anything: it copies the format pointer and
+ * the argument values (strings included) into a fixed-size record and puts
+ * it on a bounded multi-producer queue. A background thread turns records
+ * into text and writes them out, so a thousand matches logging at once never
+ * queue up behind stdout. If the queue is full the record is dropped (and
+ * counted) instead of blocking.
+ *
+ * Levels below SOCCER_LOG_MIN_LEVEL don't exist in the binary at all: their
+ * macros expand to nothing, arguments included. Above it, each module has
+ * its own runtime level (log_set_level, log_configure).
+ *
+ * Before log_start() or after log_stop(), records are formatted and written
+ * on the calling thread, so nothing is lost at startup or shutdown.
+ *
+ * The format must be a string literal (only its address is kept). `%n` is
+ * not supported.
+ *
+ * Example:
+ * @code
+ *   LOG_WARN(LOG_SCENE, "couldn't select a player for the throw-in (team %d)", team);
+ * @endcode
+ */
+
+#ifndef ENGINE_CORE_LOG_H
+#define ENGINE_CORE_LOG_H
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#define LOG_LEVEL_TRACE 0
+#define LOG_LEVEL_DEBUG 1
+#define LOG_LEVEL_INFO  2
+#define LOG_LEVEL_WARN  3
+#define LOG_LEVEL_ERROR 4
+#define LOG_LEVEL_OFF   5
+
+/** @brief Calls below this level are compiled out. Set from CMake. */
+#ifndef SOCCER_LOG_MIN_LEVEL
+#define SOCCER_LOG_MIN_LEVEL LOG_LEVEL_DEBUG
+#endif
+
+/**
+ * @enum LogModule
+ * @brief Who is talking. Each one can be turned up or down on its own.
+ */
+typedef enum {
+    LOG_CORE,
+    LOG_SCENE,
+    LOG_REFEREE,
+    LOG_MATCH,
+    LOG_REPLAY,
+    LOG_RENDER,
+    LOG_MODULE_COUNT
+} LogModule;
+
+/** @brief True if `level` messages from `module` are currently wanted. */
+bool log_enabled(int level, LogModule module);
+
+/** @brief Queues one record; use the LOG_*() macros instead. */
+void log_write(int level, LogModule module, const char* format, ...)
+#if defined(__GNUC__)
+    __attribute__((format(printf, 3, 4)))
+#endif
+    ;
+
+#define LOG_AT(level, module, ...) \
+    do { if (log_enabled((level), (module))) log_write((level), (module), __VA_ARGS__); } while (0)
+
+#if SOCCER_LOG_MIN_LEVEL <= LOG_LEVEL_TRACE
+#define LOG_TRACE(module, ...) LOG_AT(LOG_LEVEL_TRACE, module, __VA_ARGS__)
+#else
+#define LOG_TRACE(module, ...) ((void)0)
+#endif
+#if SOCCER_LOG_MIN_LEVEL <= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(module, ...) LOG_AT(LOG_LEVEL_DEBUG, module, __VA_ARGS__)
+#else
+#define LOG_DEBUG(module, ...) ((void)0)
+#endif
+#if SOCCER_LOG_MIN_LEVEL <= LOG_LEVEL_INFO
+#define LOG_INFO(module, ...) LOG_AT(LOG_LEVEL_INFO, module, __VA_ARGS__)
+#else
+#define LOG_INFO(module, ...) ((void)0)
+#endif
+#if SOCCER_LOG_MIN_LEVEL <= LOG_LEVEL_WARN
+#define LOG_WARN(module, ...) LOG_AT(LOG_LEVEL_WARN, module, __VA_ARGS__)
+#else
+#define LOG_WARN(module, ...) ((void)0)
+#endif
+#if SOCCER_LOG_MIN_LEVEL <= LOG_LEVEL_ERROR
+#define LOG_ERROR(module, ...) LOG_AT(LOG_LEVEL_ERROR, module, __VA_ARGS__)
+#else
+#define LOG_ERROR(module, ...) ((void)0)
+#endif
+
+/** @brief Sets the runtime level of one module (LOG_LEVEL_OFF silences it). */
+void log_set_level(LogModule module, int level);
+
+/**
+ * @brief Sets levels from text like "warn", "scene=debug,render=off" or
+ * "info,replay=trace" (a bare level applies to every module).
+ * @return false if something in `spec` wasn't understood; the rest is applied.
+ */
+bool log_configure(const char* spec);
+
+/**
+ * @brief Starts the background writer; records go to `out` from then on.
+ * @return false if the thread couldn't be started (logging stays synchronous).
+ */
+bool log_start(FILE* out);
+
+/** @brief Blocks until everything logged so far has been written. */
+void log_flush(void);
+
+/** @brief Writes what's queued and stops the thread. Safe to call twice (and from atexit). */
+void log_stop(void);
+
+/** @brief Records dropped so far because the queue was full. */
+unsigned long log_dropped(void);
+
+#endif
@@ -0,0 +1,78 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "mapped_file.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static bool read_whole_file(struct MappedFile *file, const char *path) {
+  FILE *f = fopen(path, "rb");
+  if (!f)
+    return false;
+
+  uint8_t *data = NULL;
+  long size = -1;
+  if (fseek(f, 0, SEEK_END) == 0)
+    size = ftell(f);
+  if (size >= 0 && fseek(f, 0, SEEK_SET) == 0) {
+    data = malloc(size > 0 ? (size_t)size : 1);
+    if (data && fread(data, 1, (size_t)size, f) != (size_t)size) {
+      free(data);
+      data = NULL;
+    }
+  }
+  fclose(f);
+  if (!data)
+    return false;
+
+  file->data = data;
+  file->size = (size_t)size;
+  file->mapped = false;
+  return true;
+}
+
+bool mapped_file_open(struct MappedFile *file, const char *path) {
+  file->data = NULL;
+  file->size = 0;
+  file->mapped = false;
+
+#ifndef _WIN32
+  int fd = open(path, O_RDONLY);
+  if (fd < 0)
+    return false;
+  struct stat st;
+  if (fstat(fd, &st) == 0 && st.st_size > 0) {
+    void *p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p != MAP_FAILED) {
+      close(fd);    // the mapping stays valid
+      file->data = p;
+      file->size = (size_t)st.st_size;
+      file->mapped = true;
+      return true;
+    }
+  }
+  close(fd);
+#endif
+  return read_whole_file(file, path);
+}
+
+void mapped_file_close(struct MappedFile *file) {
+#ifndef _WIN32
+  if (file->mapped)
+    munmap((void *)file->data, file->size);
+  else
+#endif
+    free((void *)file->data);
+  file->data = NULL;
+  file->size = 0;
+  file->mapped = false;
+}
@@ -0,0 +1,27 @@
+/**
+ * @file mapped_file.h
+ * @brief Read-only view of a whole file in memory.
+ * * On POSIX systems the file is mmap'ed, so opening a large file is instant
+ * and only the pages that are actually read get loaded. Elsewhere the file
+ * is simply read into a buffer.
+ */
+
+#ifndef ENGINE_CORE_MAPPED_FILE_H
+#define ENGINE_CORE_MAPPED_FILE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+struct MappedFile {
+  const uint8_t *data;
+  size_t size;
+  bool mapped;      /**< data came from mmap (otherwise from malloc). */
+};
+
+/** @return false if the file couldn't be opened or read. */
+bool mapped_file_open(struct MappedFile *file, const char *path);
+
+void mapped_file_close(struct MappedFile *file);
+
+#endif
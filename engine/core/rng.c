@@ -0,0 +1,38 @@
+#include "rng.h"
+
+// splitmix64: spreads similar seeds (0, 1, 2, ...) over the whole state space
+static uint64_t splitmix64(uint64_t* x) {
+  uint64_t z = (*x += 0x9E3779B97F4A7C15ull);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  return z ^ (z >> 31);
+}
+
+void rng_seed(struct Rng *rng, uint64_t seed) {
+  rng->state = splitmix64(&seed);
+  rng->inc = splitmix64(&seed) | 1u; // the increment must be odd
+}
+
+uint32_t rng_next(struct Rng *rng) {
+  uint64_t old = rng->state;
+  rng->state = old * 6364136223846793005ull + rng->inc;
+  uint32_t xorshifted = (uint32_t)(((old >> 18u) ^ old) >> 27u);
+  uint32_t rot = (uint32_t)(old >> 59u);
+  return (xorshifted >> rot) | (xorshifted << ((32u - rot) & 31u));
+}
+
+uint32_t rng_below(struct Rng *rng, uint32_t bound) {
+  if (bound == 0)
+    return 0;
+  // Lemire's multiply-and-reject: unbiased without a division in the common case
+  uint64_t m = (uint64_t)rng_next(rng) * bound;
+  uint32_t low = (uint32_t)m;
+  if (low < bound) {
+    uint32_t threshold = (0u - bound) % bound;
+    while (low < threshold) {
+      m = (uint64_t)rng_next(rng) * bound;
+      low = (uint32_t)m;
+    }
+  }
+  return (uint32_t)(m >> 32);
+}
@@ -0,0 +1,38 @@
+/**
+ * @file rng.h
+ * @brief Small, fast, seedable random number generator (PCG32).
+ * * Every Scene owns one of these instead of sharing the C library's global
+ * rand(). Two matches started with the same seed roll exactly the same
+ * numbers, and matches running on different threads never interfere.
+ */
+
+#ifndef ENGINE_CORE_RNG_H
+#define ENGINE_CORE_RNG_H
+
+#include <stdint.h>
+
+/**
+ * @struct Rng
+ * @brief PCG32 generator state. Treat the fields as private.
+ */
+struct Rng {
+    uint64_t state;
+    uint64_t inc;
+};
+
+/**
+ * @brief Seeds the generator. Any 64-bit value is a good seed.
+ */
+void rng_seed(struct Rng* rng, uint64_t seed);
+
+/**
+ * @brief Returns the next uniformly distributed 32-bit value.
+ */
+uint32_t rng_next(struct Rng* rng);
+
+/**
+ * @brief Returns a uniform integer in [0, bound). Returns 0 if bound is 0.
+ */
+uint32_t rng_below(struct Rng* rng, uint32_t bound);
+
+#endif
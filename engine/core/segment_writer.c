@@ -0,0 +1,238 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "segment_writer.h"
+#include "log.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct SegmentWriter {
+  pthread_mutex_t lock;
+  pthread_cond_t wake;      // signalled when the back buffer is handed over or on shutdown
+  pthread_cond_t done;      // signalled when the back buffer has been written
+
+  uint8_t *front;           // filled by the producer, no lock needed
+  size_t front_len;
+  size_t front_cuts[SEGMENT_WRITER_MAX_CUTS];  // where each file ending in this buffer ends
+  int front_cut_count;
+  unsigned front_first;     // file the first byte of the front buffer belongs to
+  unsigned front_segment;   // file the next byte belongs to
+  size_t reserved;
+
+  uint8_t *back;            // owned by the writer thread while back_busy
+  size_t back_len;
+  size_t back_cuts[SEGMENT_WRITER_MAX_CUTS];
+  int back_cut_count;
+  unsigned back_first;
+  bool back_busy;
+  bool stopping;
+
+  size_t size;
+  FILE *file;               // only touched by the writer thread
+  char *prefix;
+  char *suffix;
+  int max_segments;
+  pthread_t thread;
+};
+
+static void segment_path(const struct SegmentWriter *w, unsigned segment, char *out, size_t len) {
+  snprintf(out, len, "%s-%06u%s", w->prefix, segment, w->suffix);
+}
+
+static void write_part(struct SegmentWriter *w, unsigned segment, const uint8_t *data, size_t len) {
+  if (!w->file && len > 0) {
+    char path[1024];
+    segment_path(w, segment, path, sizeof(path));
+    w->file = fopen(path, "wb");
+    if (!w->file)
+      LOG_ERROR(LOG_CORE, "segment_writer: can't open %s", path);
+
+    // keep only the newest max_segments files
+    if (w->max_segments > 0 && segment >= (unsigned)w->max_segments) {
+      segment_path(w, segment - (unsigned)w->max_segments, path, sizeof(path));
+      remove(path);
+    }
+  }
+  if (w->file && len > 0)
+    fwrite(data, 1, len, w->file);
+}
+
+static void close_file(struct SegmentWriter *w) {
+  if (w->file) {
+    fclose(w->file);
+    w->file = NULL;
+  }
+}
+
+static void write_back_buffer(struct SegmentWriter *w) {
+  // the end of one file, any number of whole ones, then the start of the next
+  size_t start = 0;
+  for (int i = 0; i < w->back_cut_count; i++) {
+    write_part(w, w->back_first + (unsigned)i, w->back + start, w->back_cuts[i] - start);
+    close_file(w);
+    start = w->back_cuts[i];
+  }
+  write_part(w, w->back_first + (unsigned)w->back_cut_count, w->back + start, w->back_len - start);
+}
+
+static void *writer_main(void *arg) {
+  struct SegmentWriter *w = arg;
+
+  pthread_mutex_lock(&w->lock);
+  for (;;) {
+    while (!w->back_busy && !w->stopping)
+      pthread_cond_wait(&w->wake, &w->lock);
+    if (!w->back_busy && w->stopping)
+      break;
+
+    // the producer won't touch the back buffer until back_busy is cleared
+    pthread_mutex_unlock(&w->lock);
+    write_back_buffer(w);
+    pthread_mutex_lock(&w->lock);
+
+    w->back_busy = false;
+    pthread_cond_broadcast(&w->done);
+  }
+  pthread_mutex_unlock(&w->lock);
+
+  close_file(w);
+  return NULL;
+}
+
+static char *copy_string(const char *s) {
+  char *copy = malloc(strlen(s) + 1);
+  if (copy)
+    strcpy(copy, s);
+  return copy;
+}
+
+struct SegmentWriter *segment_writer_create(const char *prefix, const char *suffix,
+                                            int max_segments, size_t buffer_size) {
+  struct SegmentWriter *w = calloc(1, sizeof(*w));
+  if (!w)
+    return NULL;
+
+  w->size = buffer_size;
+  w->max_segments = max_segments;
+  w->front = malloc(buffer_size);
+  w->back = malloc(buffer_size);
+  w->prefix = copy_string(prefix);
+  w->suffix = copy_string(suffix ? suffix : "");
+  if (!w->front || !w->back || !w->prefix || !w->suffix)
+    goto fail;
+
+  pthread_mutex_init(&w->lock, NULL);
+  pthread_cond_init(&w->wake, NULL);
+  pthread_cond_init(&w->done, NULL);
+  if (pthread_create(&w->thread, NULL, writer_main, w) != 0) {
+    pthread_cond_destroy(&w->done);
+    pthread_cond_destroy(&w->wake);
+    pthread_mutex_destroy(&w->lock);
+    goto fail;
+  }
+  return w;
+
+fail:
+  free(w->front);
+  free(w->back);
+  free(w->prefix);
+  free(w->suffix);
+  free(w);
+  return NULL;
+}
+
+bool segment_writer_flush(struct SegmentWriter *w) {
+  pthread_mutex_lock(&w->lock);
+  if (w->back_busy) {
+    pthread_mutex_unlock(&w->lock);
+    return false;
+  }
+
+  uint8_t *full = w->front;
+  w->front = w->back;
+  w->back = full;
+  w->back_len = w->front_len;
+  memcpy(w->back_cuts, w->front_cuts, sizeof(size_t) * (size_t)w->front_cut_count);
+  w->back_cut_count = w->front_cut_count;
+  w->back_first = w->front_first;
+  w->back_busy = true;
+  w->front_len = 0;
+  w->front_cut_count = 0;
+  w->front_first = w->front_segment;
+
+  pthread_cond_signal(&w->wake);
+  pthread_mutex_unlock(&w->lock);
+  return true;
+}
+
+bool segment_writer_end_segment(struct SegmentWriter *w) {
+  if (!segment_writer_can_end_segment(w))
+    return false;
+  w->front_cuts[w->front_cut_count++] = w->front_len;
+  w->front_segment++;
+  return true;
+}
+
+bool segment_writer_can_end_segment(const struct SegmentWriter *w) {
+  return w->front_cut_count < SEGMENT_WRITER_MAX_CUTS;
+}
+
+uint8_t *segment_writer_reserve(struct SegmentWriter *w, size_t len) {
+  if (len > w->size)
+    return NULL;
+  if (w->front_len + len > w->size && !segment_writer_flush(w))
+    return NULL;
+  w->reserved = len;
+  return w->front + w->front_len;
+}
+
+void segment_writer_commit(struct SegmentWriter *w, size_t len) {
+  w->front_len += len < w->reserved ? len : w->reserved;
+  w->reserved = 0;
+}
+
+size_t segment_writer_pending(const struct SegmentWriter *w) {
+  return w->front_len;
+}
+
+unsigned segment_writer_segment(const struct SegmentWriter *w) {
+  return w->front_segment;
+}
+
+void segment_writer_wait(struct SegmentWriter *w) {
+  pthread_mutex_lock(&w->lock);
+  while (w->back_busy)
+    pthread_cond_wait(&w->done, &w->lock);
+  pthread_mutex_unlock(&w->lock);
+}
+
+void segment_writer_destroy(struct SegmentWriter *w) {
+  if (!w)
+    return;
+
+  segment_writer_wait(w);
+  segment_writer_flush(w);
+  segment_writer_wait(w);
+  segment_writer_end_segment(w);   // closes the last file
+  segment_writer_flush(w);
+  segment_writer_wait(w);
+
+  pthread_mutex_lock(&w->lock);
+  w->stopping = true;
+  pthread_cond_signal(&w->wake);
+  pthread_mutex_unlock(&w->lock);
+  pthread_join(w->thread, NULL);
+
+  pthread_cond_destroy(&w->done);
+  pthread_cond_destroy(&w->wake);
+  pthread_mutex_destroy(&w->lock);
+  free(w->front);
+  free(w->back);
+  free(w->prefix);
+  free(w->suffix);
+  free(w);
+}
@@ -0,0 +1,75 @@
+/**
+ * @file segment_writer.h
+ * @brief Writes a byte stream to rolling files from a background thread.
+ * * The producer fills a front buffer in memory; a worker thread writes the
+ * back buffer to disk. Handing a full buffer over is a pointer swap, so the
+ * producer never waits on the disk. If the worker is still busy when the
+ * front buffer fills up, reserve() fails and the producer decides what to
+ * drop, instead of blocking.
+ *
+ * The stream is cut into numbered files ("<prefix>-000000<suffix>", ...).
+ * Only the newest `max_segments` are kept, so a run that never stops uses
+ * a bounded amount of disk.
+ */
+
+#ifndef ENGINE_CORE_SEGMENT_WRITER_H
+#define ENGINE_CORE_SEGMENT_WRITER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+struct SegmentWriter;
+
+/**
+ * @brief Starts the writer thread.
+ * @param max_segments Older files beyond this many are deleted; <= 0 keeps all.
+ * @param buffer_size Size of each of the two buffers.
+ * @return NULL if memory or the thread couldn't be had.
+ */
+struct SegmentWriter *segment_writer_create(const char *prefix, const char *suffix,
+                                            int max_segments, size_t buffer_size);
+
+/**
+ * @brief Room for `len` more bytes in the front buffer, or NULL if there
+ * isn't any (the buffer is full and the writer hasn't caught up).
+ * Follow with segment_writer_commit() once the bytes are written.
+ */
+uint8_t *segment_writer_reserve(struct SegmentWriter *writer, size_t len);
+
+/** @brief Keeps the first `len` bytes of the last reservation. */
+void segment_writer_commit(struct SegmentWriter *writer, size_t len);
+
+/** @brief Bytes in the front buffer that haven't been handed to the writer yet. */
+size_t segment_writer_pending(const struct SegmentWriter *writer);
+
+/**
+ * @brief Hands the front buffer to the writer thread, if it is idle.
+ * @return false if the writer was busy and nothing happened.
+ */
+bool segment_writer_flush(struct SegmentWriter *writer);
+
+/** Files that can end within one buffer before it has to be handed over. */
+#define SEGMENT_WRITER_MAX_CUTS 16
+
+/**
+ * @brief Ends the current file here; bytes committed from now on go to the
+ * next one. Doesn't wait for the writer.
+ * @return false if the front buffer already holds the ends of
+ * SEGMENT_WRITER_MAX_CUTS files (flush it first).
+ */
+bool segment_writer_end_segment(struct SegmentWriter *writer);
+
+/** @brief Whether segment_writer_end_segment() would succeed right now. */
+bool segment_writer_can_end_segment(const struct SegmentWriter *writer);
+
+/** @brief Number of the file the next committed byte will land in. */
+unsigned segment_writer_segment(const struct SegmentWriter *writer);
+
+/** @brief Blocks until the writer thread has written everything handed to it. */
+void segment_writer_wait(struct SegmentWriter *writer);
+
+/** @brief Writes whatever is left, closes the file and stops the thread. */
+void segment_writer_destroy(struct SegmentWriter *writer);
+
+#endif
@@ -0,0 +1,178 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "thread_pool.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+struct Task {
+  ThreadPoolTask fn;
+  void *arg;
+};
+
+struct Worker {
+  struct ThreadPool *pool;
+  int index;
+  pthread_t thread;
+};
+
+struct ThreadPool {
+  pthread_mutex_t lock;
+  pthread_cond_t has_work;  // signalled when a task is queued or on shutdown
+  pthread_cond_t idle;      // signalled when the last running task finishes
+
+  struct Task *tasks;       // ring buffer
+  int capacity;
+  int head;
+  int count;
+
+  int running;              // tasks currently executing
+  int stopping;
+
+  struct Worker *workers;
+  int worker_count;
+};
+
+static void *worker_main(void *arg) {
+  struct Worker *self = arg;
+  struct ThreadPool *pool = self->pool;
+
+  pthread_mutex_lock(&pool->lock);
+  for (;;) {
+    while (pool->count == 0 && !pool->stopping)
+      pthread_cond_wait(&pool->has_work, &pool->lock);
+    if (pool->count == 0 && pool->stopping)
+      break;
+
+    struct Task task = pool->tasks[pool->head];
+    pool->head = (pool->head + 1) % pool->capacity;
+    pool->count--;
+    pool->running++;
+    pthread_mutex_unlock(&pool->lock);
+
+    task.fn(task.arg, self->index);
+
+    pthread_mutex_lock(&pool->lock);
+    pool->running--;
+    if (pool->count == 0 && pool->running == 0)
+      pthread_cond_broadcast(&pool->idle);
+  }
+  pthread_mutex_unlock(&pool->lock);
+  return NULL;
+}
+
+int thread_pool_cpu_count(void) {
+#ifdef _WIN32
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+#else
+  long n = sysconf(_SC_NPROCESSORS_ONLN);
+  return n > 0 ? (int)n : 1;
+#endif
+}
+
+struct ThreadPool *thread_pool_create(int workers) {
+  if (workers <= 0)
+    workers = thread_pool_cpu_count();
+
+  struct ThreadPool *pool = calloc(1, sizeof(struct ThreadPool));
+  if (!pool)
+    return NULL;
+
+  pool->capacity = 64;
+  pool->tasks = malloc(sizeof(struct Task) * pool->capacity);
+  pool->workers = calloc(workers, sizeof(struct Worker));
+  if (!pool->tasks || !pool->workers) {
+    free(pool->tasks);
+    free(pool->workers);
+    free(pool);
+    return NULL;
+  }
+
+  pthread_mutex_init(&pool->lock, NULL);
+  pthread_cond_init(&pool->has_work, NULL);
+  pthread_cond_init(&pool->idle, NULL);
+
+  for (int i = 0; i < workers; i++) {
+    struct Worker *w = &pool->workers[pool->worker_count];
+    w->pool = pool;
+    w->index = pool->worker_count;
+    if (pthread_create(&w->thread, NULL, worker_main, w) != 0)
+      break;
+    pool->worker_count++;
+  }
+
+  if (pool->worker_count == 0) {
+    thread_pool_destroy(pool);
+    return NULL;
+  }
+  return pool;
+}
+
+int thread_pool_size(const struct ThreadPool *pool) {
+  return pool->worker_count;
+}
+
+int thread_pool_submit(struct ThreadPool *pool, ThreadPoolTask fn, void *arg) {
+  pthread_mutex_lock(&pool->lock);
+
+  if (pool->count == pool->capacity) {
+    // grow and unwrap the ring so the queued tasks start at index 0
+    int capacity = pool->capacity * 2;
+    struct Task *tasks = malloc(sizeof(struct Task) * capacity);
+    if (!tasks) {
+      pthread_mutex_unlock(&pool->lock);
+      return -1;
+    }
+    for (int i = 0; i < pool->count; i++)
+      tasks[i] = pool->tasks[(pool->head + i) % pool->capacity];
+    free(pool->tasks);
+    pool->tasks = tasks;
+    pool->capacity = capacity;
+    pool->head = 0;
+  }
+
+  int tail = (pool->head + pool->count) % pool->capacity;
+  pool->tasks[tail].fn = fn;
+  pool->tasks[tail].arg = arg;
+  pool->count++;
+
+  pthread_cond_signal(&pool->has_work);
+  pthread_mutex_unlock(&pool->lock);
+  return 0;
+}
+
+void thread_pool_wait(struct ThreadPool *pool) {
+  pthread_mutex_lock(&pool->lock);
+  while (pool->count > 0 || pool->running > 0)
+    pthread_cond_wait(&pool->idle, &pool->lock);
+  pthread_mutex_unlock(&pool->lock);
+}
+
+void thread_pool_destroy(struct ThreadPool *pool) {
+  if (!pool)
+    return;
+
+  pthread_mutex_lock(&pool->lock);
+  pool->stopping = 1;
+  pthread_cond_broadcast(&pool->has_work);
+  pthread_mutex_unlock(&pool->lock);
+
+  for (int i = 0; i < pool->worker_count; i++)
+    pthread_join(pool->workers[i].thread, NULL);
+
+  pthread_mutex_destroy(&pool->lock);
+  pthread_cond_destroy(&pool->has_work);
+  pthread_cond_destroy(&pool->idle);
+  free(pool->tasks);
+  free(pool->workers);
+  free(pool);
+}
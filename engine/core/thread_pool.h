@@ -0,0 +1,41 @@
+/**
+ * @file thread_pool.h
+ * @brief Fixed-size pool of worker threads consuming a FIFO task queue.
+ * * Tasks receive the index of the worker running them, so callers can keep
+ * per-worker scratch state (a Scene, a frame buffer, ...) in a plain array
+ * instead of allocating it for every task.
+ */
+
+#ifndef ENGINE_CORE_THREAD_POOL_H
+#define ENGINE_CORE_THREAD_POOL_H
+
+/** @brief Work item signature. `worker` is in [0, thread_pool_size()). */
+typedef void (*ThreadPoolTask)(void* arg, int worker);
+
+struct ThreadPool;
+
+/**
+ * @brief Starts `workers` threads. Non-positive values use one per CPU.
+ * @return The pool, or NULL if no thread could be started.
+ */
+struct ThreadPool* thread_pool_create(int workers);
+
+/** @brief Number of worker threads in the pool. */
+int thread_pool_size(const struct ThreadPool* pool);
+
+/**
+ * @brief Queues a task. Never blocks on running tasks.
+ * @return 0 on success, -1 if the queue couldn't grow.
+ */
+int thread_pool_submit(struct ThreadPool* pool, ThreadPoolTask fn, void* arg);
+
+/** @brief Blocks until every submitted task has finished. */
+void thread_pool_wait(struct ThreadPool* pool);
+
+/** @brief Finishes queued tasks, joins the workers and frees the pool. */
+void thread_pool_destroy(struct ThreadPool* pool);
+
+/** @brief Number of online CPUs (at least 1). */
+int thread_pool_cpu_count(void);
+
+#endif
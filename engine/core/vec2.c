@@ -1,5 +1,8 @@
 #include "vec2.h"
+#include "fixed.h"
+
 #include <math.h>
+#include <stdint.h>
 
 void vec2_add(struct Vec2 *out, const struct Vec2 *a, const struct Vec2 *b) {
   out->x = a->x + b->x;
@@ -16,6 +19,23 @@ void mulVec2(struct Vec2 *out, struct Vec2 *a, struct Vec2 *b) {
   out->y = a->y * b->y;
 }
 
+#ifdef SOCCER_FIXED_POINT
+/* Products of coordinates don't fit Q16.16: they stay Q32.32 and are
+ * converted once at the end. */
+static float wide_to_float(int64_t v) { return (float)v / 4294967296.0f; }
+
+float dotProduct(struct Vec2 *a, struct Vec2 *b) {
+  const struct FixedVec2 fa = fvec2_from(*a), fb = fvec2_from(*b);
+  return wide_to_float((int64_t)fa.x * fb.x + (int64_t)fa.y * fb.y);
+}
+
+float vec2Determinant(struct Vec2 *a, struct Vec2 *b) {
+  const struct FixedVec2 fa = fvec2_from(*a), fb = fvec2_from(*b);
+  return wide_to_float((int64_t)fa.x * fb.y - (int64_t)fa.y * fb.x);
+}
+
+float lengthVec2(struct Vec2 *a) { return fixed_to_float(fvec2_length(fvec2_from(*a))); }
+#else
 float dotProduct(struct Vec2 *a, struct Vec2 *b) {
   return a->x * b->x + a->y * b->y;
 }
@@ -25,5 +45,44 @@ float vec2Determinant(struct Vec2 *a, struct Vec2 *b) {
 }
 
 float lengthVec2(struct Vec2 *a) { return sqrt(a->x * a->x + a->y * a->y); }
+#endif
 
 float vec2Rotation(struct Vec2 *a) { return atan2(a->y, a->x); }
+
+#ifdef SOCCER_FIXED_POINT
+float vec2SegmentDistance(struct Vec2 *p, struct Vec2 *a, struct Vec2 *b) {
+  const struct FixedVec2 fp = fvec2_from(*p), fa = fvec2_from(*a);
+  const struct FixedVec2 d = fvec2_sub(fvec2_from(*b), fa);
+  const struct FixedVec2 ap = fvec2_sub(fp, fa);
+  const uint64_t len2 = fixed_length_sq(d.x, d.y);
+  const int64_t along = (int64_t)ap.x * d.x + (int64_t)ap.y * d.y;
+
+  // t = along / len2 in [0, 1], one bit at a time so nothing overflows
+  fixed t = 0;
+  if (len2 > 0 && along >= (int64_t)len2) {
+    t = FIXED_ONE;
+  } else if (len2 > 0 && along > 0) {
+    uint64_t rest = (uint64_t)along;
+    for (int bit = 0; bit < FIXED_SHIFT; bit++) {
+      rest <<= 1;
+      t <<= 1;
+      if (rest >= len2) {
+        rest -= len2;
+        t |= 1;
+      }
+    }
+  }
+  const struct FixedVec2 closest = fvec2_add(fa, fvec2_scale(d, t));
+  return fixed_to_float(fvec2_length(fvec2_sub(closest, fp)));
+}
+#else
+float vec2SegmentDistance(struct Vec2 *p, struct Vec2 *a, struct Vec2 *b) {
+  const float dx = b->x - a->x, dy = b->y - a->y;
+  const float len2 = dx * dx + dy * dy;
+  float t = len2 > 0.0f ? ((p->x - a->x) * dx + (p->y - a->y) * dy) / len2 : 0.0f;
+  if (t < 0.0f) t = 0.0f;
+  if (t > 1.0f) t = 1.0f;
+  const float cx = a->x + t * dx - p->x, cy = a->y + t * dy - p->y;
+  return sqrtf(cx * cx + cy * cy);
+}
+#endif
@@ -22,4 +22,8 @@ float vec2Determinant(struct Vec2 *a, struct Vec2 *b);
 float lengthVec2(struct Vec2 *a);
 float vec2Rotation(struct Vec2 *a);
 
+/** Distance from point p to the segment a-b. A circle at p touches the segment
+ *  when this is <= its radius. */
+float vec2SegmentDistance(struct Vec2 *p, struct Vec2 *a, struct Vec2 *b);
+
 #endif
@@ -18,6 +18,7 @@
 struct Ball {
     struct Vec2 position;
     struct Vec2 velocity;
+    struct Vec2 prev_position;  /**< Position before the last tick; the renderer interpolates from here. */
     const float radius;
     struct Player* possessor;   /**< Pointer to the player currently holding the ball. NULL if free. */
 
@@ -31,6 +32,7 @@ static inline struct Ball make_ball(float x, float y) {
     struct Ball b = {
         .position = {x, y},
         .velocity = {0, 0},
+        .prev_position = {x, y},
         .radius = BALL_RADIUS,
         .possessor  = NULL,
         .last_team = 0
@@ -39,15 +41,23 @@ static inline struct Ball make_ball(float x, float y) {
 }
 
 /**
- * @brief Helper to allocate a ball on the heap.
+ * @brief Helper to build a ball in memory the caller provides (e.g. an arena).
+ * @return `memory` as a Ball, or NULL if `memory` is NULL.
  */
-static inline struct Ball* make_ball_ptr(float x, float y) {
-    struct Ball *b = malloc(sizeof(struct Ball));
-    if (b) {
+static inline struct Ball* make_ball_at(void* memory, float x, float y) {
+    if (memory) {
+        // memcpy, because assignment can't write the const radius
         struct Ball temp = make_ball(x, y);
-        memcpy(b, &temp, sizeof(struct Ball));
+        memcpy(memory, &temp, sizeof(struct Ball));
     }
-    return b;
+    return (struct Ball*)memory;
+}
+
+/**
+ * @brief Helper to allocate a ball on the heap.
+ */
+static inline struct Ball* make_ball_ptr(float x, float y) {
+    return make_ball_at(malloc(sizeof(struct Ball)), x, y);
 }
 
 #endif
@@ -13,41 +13,51 @@
  * @return Initialized Player structure.
  */
 struct Player make_player(const float x, const float y, const int team, const int kit) {
+    // the coach writes PLAYER_COUNT roles per team; bigger teams reuse them
+    const int role = kit % PLAYER_COUNT;
     struct Player p = {
         .position = {x, y},
         .velocity = {0, 0},
+        .prev_position = {x, y},
         .radius = PLAYER_RADIUS,
-        .talents = get_talents(team, kit),
+        .talents = get_talents(team, role),
         .state = IDLE,
         .team = team,
         .kit = kit,
 
-        .movement_logic     = get_movement_logic(team, kit),
-        .shooting_logic     = get_shooting_logic(team, kit),
-        .change_state_logic = get_change_state_logic(team, kit),
+        .movement_logic     = get_movement_logic(team, role),
+        .shooting_logic     = get_shooting_logic(team, role),
+        .change_state_logic = get_change_state_logic(team, role),
     };
     verify_talents(p.talents);
     return p;
 }
 
 /**
- * @brief Creates a heap-allocated Player instance.
- * @param x Initial x-coordinate.
- * @param y Initial y-coordinate.
- * @param talents Player's skill attributes.
- * @return Pointer to newly allocated Player, or NULL on allocation failure.
+ * @brief Builds a Player in memory the caller provides (e.g. an arena).
+ * @param memory At least sizeof(struct Player) suitably aligned bytes.
+ * @return `memory` as a Player, or NULL if `memory` is NULL.
  */
-
-struct Player *make_player_ptr(const float x, const float y, const int team, const int kit) {
-    struct Player *p = malloc(sizeof(struct Player));
-    if (!p) return NULL;
+struct Player *make_player_at(void *memory, const float x, const float y, const int team, const int kit) {
+    if (!memory) return NULL;
 
     // We create a temporary stack player
     struct Player temp = make_player(x, y, team, kit);
 
-    // We use memcpy to copy the bytes from the temp player to the heap.
+    // We use memcpy to copy the bytes from the temp player to the destination.
     // This ignores the 'const' qualifiers during the copy process.
-    memcpy(p, &temp, sizeof(struct Player));
+    memcpy(memory, &temp, sizeof(struct Player));
 
-    return p;
-}
\ No newline at end of file
+    return (struct Player *)memory;
+}
+
+/**
+ * @brief Creates a heap-allocated Player instance.
+ * @param x Initial x-coordinate.
+ * @param y Initial y-coordinate.
+ * @param talents Player's skill attributes.
+ * @return Pointer to newly allocated Player, or NULL on allocation failure.
+ */
+struct Player *make_player_ptr(const float x, const float y, const int team, const int kit) {
+    return make_player_at(malloc(sizeof(struct Player)), x, y, team, kit);
+}
@@ -46,6 +46,7 @@ struct Talents {
 typedef struct Player {
     struct Vec2 position;
     struct Vec2 velocity;
+    struct Vec2 prev_position;  /**< Position before the last tick; the renderer interpolates from here. */
     const float radius;
     
     PlayerActionState state;
@@ -65,6 +66,7 @@ typedef struct Player {
 
 // Allocation functions
 struct Player make_player(float x, float y, int team, const int kit);
+struct Player *make_player_at(void *memory, float x, float y, int team, const int kit);
 struct Player *make_player_ptr(float x, float y, int team, const int kit);
 
 #endif /* ENGINE_ENTITIES_PLAYER_H */
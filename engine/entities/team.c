@@ -17,15 +17,18 @@ void update_team(struct Scene* scene, struct Team* team) {
     struct Ball* ball = scene->ball;
 
     // STEP 1: THINK
-    for (int i = 0; i < PLAYER_COUNT; i++)
+    uint64_t start = profile_begin(scene->profiler);
+    for (int i = 0; i < team->size; i++)
         if (players[i] && players[i]->change_state_logic) {
             players[i]->change_state_logic(players[i], scene);
             verify_state(players[i], scene);
         }
+    profile_end(scene->profiler, PROFILE_THINK, start);
 
 
     // STEP 2: ACT
-    for (int i = 0; i < PLAYER_COUNT; i++) {
+    start = profile_begin(scene->profiler);
+    for (int i = 0; i < team->size; i++) {
         if (players[i]) {
             struct Player *player = players[i];
             switch (player->state) {
@@ -59,6 +62,7 @@ void update_team(struct Scene* scene, struct Team* team) {
             }
         }
     }
+    profile_end(scene->profiler, PROFILE_ACT, start);
 }
 
 /**
@@ -68,7 +72,9 @@ void update_team(struct Scene* scene, struct Team* team) {
  */
 struct Team make_team() {
     struct Team t = {
-        .score = 0
+        .score = 0,
+        .size = 0,
+        .players = NULL
     };
     return t;
 }
@@ -17,7 +17,8 @@ struct Scene;  /**< Forward declaration of Scene for update functions. */
  */
 struct Team {
     unsigned int score;
-    struct Player *players[PLAYER_COUNT];
+    int size;                   /**< Players in the team. */
+    struct Player **players;    /**< `size` pointers, indexed by kit; owned by whoever made the team. */
 };
 
 /**
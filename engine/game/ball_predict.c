@@ -0,0 +1,219 @@
+#include "ball_predict.h"
+#include "perception.h"
+#include "scene.h"
+#include "entities/ball.h"
+#include "core/constants.h"
+#include "core/fixed.h"
+
+#include <limits.h>
+#include <math.h>
+
+/* ticks a ball that never slows down is assumed to keep moving */
+#define NEVER_STOPS (INT_MAX / 2)
+
+void ball_path_init(struct BallPath* path, struct Vec2 position, struct Vec2 velocity,
+                    float radius, float dt) {
+    path->origin = position;
+    path->velocity = velocity;
+    path->radius = radius;
+    path->dt = dt;
+#ifdef SOCCER_FIXED_POINT
+    path->step = fixed_to_float(fixed_from_float(dt));    // the engine moves the ball by a Q16.16 dt
+#else
+    path->step = dt;
+#endif
+    path->friction = ball_friction_per_tick(dt);   // the factor the engine slows the ball by
+    path->lo = (struct Vec2){radius, radius};
+    path->hi = (struct Vec2){SCREEN_WIDTH - radius, SCREEN_HEIGHT - radius};
+
+    // the engine moves the ball, slows it, then stops it once speed * f^n < BALL_STOP_SPEED
+    const float speed = hypotf(velocity.x, velocity.y);
+    if (speed == 0.0f)
+        path->stop_tick = 0;
+    else if (path->friction >= 1.0f)
+        path->stop_tick = speed < BALL_STOP_SPEED ? 1 : NEVER_STOPS;
+    else if (speed < BALL_STOP_SPEED)
+        path->stop_tick = 1;
+    else
+        path->stop_tick = (int)floorf(logf(BALL_STOP_SPEED / speed) / logf(path->friction)) + 1;
+}
+
+void ball_path_from_scene(struct BallPath* path, const struct Scene* scene) {
+    const struct Ball* ball = scene->ball;
+    ball_path_init(path, ball->position, ball->velocity, ball->radius, scene->tick_dt);
+}
+
+/* Seconds-worth of velocity covered after n ticks: step * (1 - f^n) / (1 - f) */
+static float travel(const struct BallPath* path, float n) {
+    if (n > (float)path->stop_tick) n = (float)path->stop_tick;
+    if (n <= 0.0f) return 0.0f;
+    const float f = path->friction;
+    if (f >= 1.0f) return path->step * n;
+    return path->step * (1.0f - powf(f, n)) / (1.0f - f);
+}
+
+/* Seconds until travel() reaches `amount`, interpolating inside the tick; INFINITY if never. */
+static float travel_time(const struct BallPath* path, float amount) {
+    if (amount <= 0.0f) return 0.0f;
+    if (amount > travel(path, (float)path->stop_tick)) return INFINITY;
+
+    const float f = path->friction;
+    float x = (f >= 1.0f) ? amount / path->step
+                          : logf(1.0f - amount * (1.0f - f) / path->step) / logf(f);
+    int n = (int)floorf(x);
+    if (n < 0) n = 0;
+    if (n > path->stop_tick - 1) n = path->stop_tick - 1;
+
+    const float before = travel(path, (float)n);
+    const float step = travel(path, (float)(n + 1)) - before;
+    float frac = step > 0.0f ? (amount - before) / step : 0.0f;
+    frac = frac < 0.0f ? 0.0f : (frac > 1.0f ? 1.0f : frac);
+    return ((float)n + frac) * path->dt;
+}
+
+/* Maps a straight-line coordinate back into [lo, hi], mirroring at the edges. */
+static float fold(float u, float lo, float hi) {
+    const float span = hi - lo;
+    if (span <= 0.0f) return lo;
+    float m = fmodf(u - lo, 2.0f * span);
+    if (m < 0.0f) m += 2.0f * span;
+    return m <= span ? lo + m : lo + 2.0f * span - m;
+}
+
+static struct Vec2 unfolded_to_position(const struct BallPath* path, float g) {
+    return (struct Vec2){
+        fold(path->origin.x + path->velocity.x * g, path->lo.x, path->hi.x),
+        fold(path->origin.y + path->velocity.y * g, path->lo.y, path->hi.y),
+    };
+}
+
+struct Vec2 ball_path_at_tick(const struct BallPath* path, int tick) {
+    return unfolded_to_position(path, travel(path, (float)tick));
+}
+
+struct Vec2 ball_path_position(const struct BallPath* path, float t) {
+    if (t <= 0.0f) return unfolded_to_position(path, 0.0f);
+    const float ticks = t / path->dt;
+    const float n = floorf(ticks);
+    const float a = travel(path, n);
+    const float b = travel(path, n + 1.0f);
+    return unfolded_to_position(path, a + (b - a) * (ticks - n));
+}
+
+float ball_path_stop_time(const struct BallPath* path) {
+    return path->stop_tick >= NEVER_STOPS ? INFINITY : path->stop_tick * path->dt;
+}
+
+struct Vec2 ball_path_stop_point(const struct BallPath* path) {
+    return ball_path_at_tick(path, path->stop_tick);
+}
+
+/*
+ * On the unfolded line the coordinate only ever moves one way. The folded
+ * coordinate equals c wherever the unfolded one hits an image of c:
+ * c + 2kL or (2lo - c) + 2kL. Find the first image ahead of us.
+ */
+static float cross_axis(const struct BallPath* path, float origin, float v,
+                        float lo, float hi, float c) {
+    if (c < lo || c > hi) return INFINITY;
+    if (v == 0.0f) return origin == c ? 0.0f : INFINITY;
+
+    const float period = 2.0f * (hi - lo);
+    const float bases[2] = {c, 2.0f * lo - c};
+    float best = INFINITY;
+    for (int i = 0; i < 2; i++) {
+        float dist;
+        if (period <= 0.0f) {
+            dist = fabsf(bases[i] - origin);
+        } else if (v > 0.0f) {
+            const float k = ceilf((origin - bases[i]) / period);
+            dist = bases[i] + k * period - origin;
+        } else {
+            const float k = floorf((origin - bases[i]) / period);
+            dist = origin - (bases[i] + k * period);
+        }
+        if (dist < best) best = dist;
+    }
+    return travel_time(path, best / fabsf(v));
+}
+
+float ball_path_cross_x(const struct BallPath* path, float x) {
+    return cross_axis(path, path->origin.x, path->velocity.x, path->lo.x, path->hi.x, x);
+}
+
+float ball_path_cross_y(const struct BallPath* path, float y) {
+    return cross_axis(path, path->origin.y, path->velocity.y, path->lo.y, path->hi.y, y);
+}
+
+/* > = 0 once the player can be at the ball by tick n */
+static float slack(const struct BallPath* path, struct Vec2 from, float max_speed, float reach,
+                   int n) {
+    const struct Vec2 b = ball_path_at_tick(path, n);
+    return max_speed * n * path->dt + reach - hypotf(b.x - from.x, b.y - from.y);
+}
+
+/*
+ * While the ball is faster than the player, slack can go up and down, so we
+ * walk forward; but it can't grow by more than (player + ball speed) * dt a
+ * tick, which lets us jump over ticks that can't possibly work. Once the ball
+ * is slower than the player, slack only grows, so bisection finds the tick.
+ * After the ball stops, the answer is plain distance over speed.
+ */
+float ball_path_intercept(const struct BallPath* path, struct Vec2 from, float max_speed,
+                          float reach) {
+    const float speed0 = hypotf(path->velocity.x, path->velocity.y);
+    const int stop = path->stop_tick;
+    const float f = path->friction;
+
+    int slow = 0;   // first tick the ball is slower than the player
+    if (speed0 > max_speed) {
+        if (max_speed <= 0.0f || f >= 1.0f) slow = stop;
+        else slow = (int)ceilf(logf(max_speed / speed0) / logf(f));
+        if (slow > stop) slow = stop;
+    }
+
+    for (int n = 0; n < slow;) {
+        const float s = slack(path, from, max_speed, reach, n);
+        if (s >= 0.0f) return n * path->dt;
+        const float bound = (max_speed + speed0 * powf(f, (float)n)) * path->dt;
+        const int skip = (int)ceilf(-s / bound);
+        n += skip > 1 ? skip : 1;
+    }
+
+    if (stop < NEVER_STOPS && slack(path, from, max_speed, reach, stop) < 0.0f) {
+        // still out of reach when the ball stops
+        if (max_speed <= 0.0f) return INFINITY;
+        const struct Vec2 rest = ball_path_stop_point(path);
+        return (hypotf(rest.x - from.x, rest.y - from.y) - reach) / max_speed;
+    }
+
+    int lo = slow, hi = stop < NEVER_STOPS ? stop : slow;
+    if (stop >= NEVER_STOPS) {
+        // no stop tick to bound the search: double until reachable
+        int step = 1;
+        while (slack(path, from, max_speed, reach, hi) < 0.0f) {
+            if (max_speed <= 0.0f || hi > NEVER_STOPS - step) return INFINITY;
+            lo = hi;
+            hi += step;
+            step *= 2;
+        }
+    }
+    while (lo < hi) {
+        const int mid = lo + (hi - lo) / 2;
+        if (slack(path, from, max_speed, reach, mid) >= 0.0f) hi = mid;
+        else lo = mid + 1;
+    }
+    return lo * path->dt;
+}
+
+void ball_path_intercepts(const struct BallPath* path, const struct Scene* scene, float* out) {
+    const struct Perception* per = &scene->perception;
+    for (int i = 0; i < per->count; i++) {
+        if (!scene->players.view[i]) {
+            out[i] = INFINITY;
+            continue;
+        }
+        const struct Vec2 from = {per->x[i], per->y[i]};
+        out[i] = ball_path_intercept(path, from, per->max_speed[i], PLAYER_RADIUS + path->radius);
+    }
+}
@@ -0,0 +1,99 @@
+/**
+ * @file ball_predict.h
+ * @brief Where a free ball will be, without stepping the physics.
+ * * Every tick the ball moves by velocity * dt and then its velocity is
+ * multiplied by the same friction factor f. After n ticks it has therefore
+ * travelled
+ *
+ *     dt * v0 * (1 - f^n) / (1 - f)
+ *
+ * and it stops on the first tick its speed drops below BALL_STOP_SPEED.
+ * Bouncing off a window edge only flips the sign of one component, so it is
+ * handled by "folding" the straight-line path back into the window.
+ *
+ * The prediction assumes nobody touches the ball. f comes from
+ * ball_friction_per_tick() (game/scene.h), like the engine's, so it matches
+ * the real simulation up to rounding, except right at a bounce, where the
+ * engine clamps the ball to the edge instead of mirroring it. That holds in
+ * fixed-point builds too, but the prediction itself is float math (powf,
+ * logf), like the rest of the coaches' perception.
+ *
+ * Example (inside a change_state_logic function):
+ * @code
+ *   struct BallPath path;
+ *   ball_path_from_scene(&path, scene);
+ *   float mine = ball_path_intercept(&path, self->position,
+ *                                    MAX_PLAYER_VELOCITY * self->talents.agility / MAX_TALENT_PER_SKILL,
+ *                                    self->radius + scene->ball->radius);
+ * @endcode
+ */
+
+#ifndef ENGINE_GAME_BALL_PREDICT_H
+#define ENGINE_GAME_BALL_PREDICT_H
+
+#include "core/vec2.h"
+
+struct Scene;
+
+/** Speed (px/s) below which the engine stops the ball. */
+#define BALL_STOP_SPEED 10.0f
+
+/**
+ * @struct BallPath
+ * @brief Everything needed to evaluate the ball's future; cheap to copy.
+ */
+struct BallPath {
+    struct Vec2 origin;     /**< Position now. */
+    struct Vec2 velocity;   /**< Velocity now. */
+    float radius;
+    float dt;               /**< Tick length, seconds. */
+    float step;             /**< Seconds of velocity the ball moves per tick: dt, rounded to Q16.16 in fixed-point builds. */
+    float friction;         /**< Velocity factor per tick. */
+    int stop_tick;          /**< Number of ticks the ball still moves. */
+    struct Vec2 lo, hi;     /**< Where the ball's centre can be (window minus radius). */
+};
+
+/** @brief Path of a ball at `position` moving with `velocity`, with ticks of `dt` seconds. */
+void ball_path_init(struct BallPath* path, struct Vec2 position, struct Vec2 velocity,
+                    float radius, float dt);
+
+/** @brief Path of the scene's ball from the start of this tick. */
+void ball_path_from_scene(struct BallPath* path, const struct Scene* scene);
+
+/** @brief Ball position after `tick` more ticks. */
+struct Vec2 ball_path_at_tick(const struct BallPath* path, int tick);
+
+/** @brief Ball position after `t` seconds (interpolated between ticks, like the renderer). */
+struct Vec2 ball_path_position(const struct BallPath* path, float t);
+
+/** @brief Seconds until the ball stops. */
+float ball_path_stop_time(const struct BallPath* path);
+
+/** @brief Where the ball comes to rest. */
+struct Vec2 ball_path_stop_point(const struct BallPath* path);
+
+/**
+ * @name Line crossings
+ * @brief Earliest time (seconds) the ball's centre reaches the vertical line
+ * at `x` / the horizontal line at `y`, or INFINITY if it stops first.
+ */
+///@{
+float ball_path_cross_x(const struct BallPath* path, float x);
+float ball_path_cross_y(const struct BallPath* path, float y);
+///@}
+
+/**
+ * @brief Earliest time a player at `from` running at `max_speed` can get
+ * within `reach` of the ball's centre.
+ * @return Seconds; INFINITY if max_speed is 0 and the ball never comes within reach.
+ */
+float ball_path_intercept(const struct BallPath* path, struct Vec2 from, float max_speed,
+                          float reach);
+
+/**
+ * @brief ball_path_intercept for every player, using the perception snapshot.
+ * @param out Indexed by player slot (see player_block.h); empty slots get INFINITY.
+ */
+void ball_path_intercepts(const struct BallPath* path, const struct Scene* scene, float* out);
+
+#endif
@@ -0,0 +1,192 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "events.h"
+#include "scene.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define RING_MASK (EVENT_RING_CAPACITY - 1u)
+
+void events_init(struct EventRing* ring) {
+    memset(ring, 0, sizeof(*ring));
+}
+
+void events_subscribe(struct EventRing* ring, uint32_t mask) {
+    store_relaxed(&ring->mask, mask);
+}
+
+void events_push(struct EventRing* ring, const struct MatchEvent* event) {
+    const uint32_t head = ring->head;
+    // the consumer's release of `tail` hands the slot back to us
+    if (head - load_acquire(&ring->tail) >= EVENT_RING_CAPACITY) {
+        fetch_add_relaxed(&ring->dropped, 1u);
+        return;
+    }
+    ring->slot[head & RING_MASK] = *event;
+    store_release(&ring->head, head + 1u);
+}
+
+size_t events_drain(struct EventRing* ring, EventHandler handler, void* user) {
+    uint32_t tail = ring->tail;
+    const uint32_t head = load_acquire(&ring->head);
+    size_t handled = 0;
+    while (tail != head) {
+        // copy out first: the slot is the producer's again once tail moves
+        const struct MatchEvent event = ring->slot[tail & RING_MASK];
+        store_release(&ring->tail, ++tail);
+        handler(&event, user);
+        handled++;
+    }
+    return handled;
+}
+
+unsigned long events_dropped(const struct EventRing* ring) {
+    return load_relaxed(&ring->dropped);
+}
+
+static const char* violation_text(int code) {
+    switch (code) {
+        case VIOLATION_SHOOT_WITHOUT_BALL: return "the ball is not yours, you can't shoot!";
+        case VIOLATION_RUN_X:              return "Demanding to run too fast in dimension x!";
+        case VIOLATION_RUN_Y:              return "Demanding to run too fast in dimension y!";
+        case VIOLATION_SHOOT_X:            return "Demanding to shoot too fast in dimension x!";
+        case VIOLATION_SHOOT_Y:            return "Demanding to shoot too fast in dimension y!";
+        case VIOLATION_KICKOFF_HALF:       return "You must pass to your own half!";
+        default:                           return "unknown violation";
+    }
+}
+
+int match_event_format(const struct MatchEvent* e, char* out, size_t len) {
+    switch ((MatchEventType)e->type) {
+        case EVENT_KICKOFF:
+            return snprintf(out, len, "Team %d is about to kick-off\n", e->team);
+        case EVENT_RESTART:
+            return snprintf(out, len, "the player should now kick-off / throw-in ... \n");
+        case EVENT_GOAL:
+            return snprintf(out, len, "Goal scored!\nfirst team score: %d\nsecond team score: %d\n",
+                            e->value[0], e->value[1]);
+        case EVENT_OUT:
+            return snprintf(out, len, "Ball out of bounds!\n");
+        case EVENT_NET_HIT:
+            return snprintf(out, len, "GOAL! %s net hit at x:%.2f, y=%.2f\n",
+                            e->team == 1 ? "Right" : "Left", e->x, e->y);
+        case EVENT_BALL_OUT:
+            return snprintf(out, len, "Ball is out: x=%.2f, y=%.2f\n", e->x, e->y);
+        case EVENT_POSSESSION:
+            return snprintf(out, len, "Team %d player %d has the ball\n", e->team, e->kit);
+        case EVENT_TACKLE:
+            return snprintf(out, len, "Team %d player %d %s the ball from team %d player %d\n",
+                            e->team, e->kit, e->code ? "won" : "failed to win",
+                            e->other_team, e->other_kit);
+        case EVENT_VIOLATION:
+            if (e->code == VIOLATION_TALENTS)
+                return snprintf(out, len, "ERROR: Invalid talents! Values: defence=%d, agility=%d, "
+                                "dribbling=%d, shooting=%d, sum=%d\n",
+                                e->value[0], e->value[1], e->value[2], e->value[3], e->value[4]);
+            return snprintf(out, len, " ERROR: %s (team %d, player %d)\n",
+                            violation_text(e->code), e->team, e->kit);
+        case EVENT_FULL_TIME:
+            return snprintf(out, len, "Game Time has ended ...\n");
+        default:
+            if (len > 0) out[0] = '\0';
+            return 0;
+    }
+}
+
+void match_event_print(const struct MatchEvent* event, void* file) {
+    char text[256];
+    if (match_event_format(event, text, sizeof(text)) > 0)
+        fputs(text, (FILE*)file);
+}
+
+// ---------------------------------------------------------------------------
+// Pump thread
+
+struct EventPump {
+    struct EventRing* ring;
+    EventHandler handler;
+    void* user;
+    int stopping;
+    pthread_t thread;
+};
+
+static void* pump_main(void* arg) {
+    struct EventPump* pump = arg;
+    const struct timespec nap = {0, 1000000};   // 1 ms between empty polls
+    for (;;) {
+        // read the flag before draining, so nothing pushed before stop is missed
+        const int stopping = load_acquire(&pump->stopping);
+        const size_t handled = events_drain(pump->ring, pump->handler, pump->user);
+        if (stopping)
+            break;
+        if (handled == 0)
+            nanosleep(&nap, NULL);
+    }
+    return NULL;
+}
+
+struct EventPump* events_pump_start(struct EventRing* ring, EventHandler handler, void* user) {
+    struct EventPump* pump = malloc(sizeof(*pump));
+    if (!pump)
+        return NULL;
+    pump->ring = ring;
+    pump->handler = handler;
+    pump->user = user;
+    pump->stopping = 0;
+    if (pthread_create(&pump->thread, NULL, pump_main, pump) != 0) {
+        free(pump);
+        return NULL;
+    }
+    return pump;
+}
+
+void events_pump_stop(struct EventPump* pump) {
+    if (!pump)
+        return;
+    store_release(&pump->stopping, 1);
+    pthread_join(pump->thread, NULL);
+    free(pump);
+}
+
+// ---------------------------------------------------------------------------
+// Reporting without a Scene
+
+static THREAD_LOCAL struct Scene* bound_scene;
+
+void events_bind(struct Scene* scene) {
+    bound_scene = scene;
+}
+
+static void raise_bound(struct MatchEvent event) {
+    if (bound_scene)
+        event_raise(&bound_scene->events, event);
+}
+
+void event_violation(enum Violation violation, const struct Player* player) {
+    raise_bound((struct MatchEvent){
+        .type = EVENT_VIOLATION, .code = (uint8_t)violation,
+        .team = (uint8_t)player->team, .kit = (uint8_t)player->kit,
+        .x = player->position.x, .y = player->position.y,
+    });
+}
+
+void event_talents(struct Talents talents, int sum) {
+    raise_bound((struct MatchEvent){
+        .type = EVENT_VIOLATION, .code = VIOLATION_TALENTS,
+        .value = {talents.defence, talents.agility, talents.dribbling, talents.shooting, sum},
+    });
+}
+
+void event_net_hit(int team, float x, float y) {
+    raise_bound((struct MatchEvent){.type = EVENT_NET_HIT, .team = (uint8_t)team, .x = x, .y = y});
+}
+
+void event_ball_out(float x, float y) {
+    raise_bound((struct MatchEvent){.type = EVENT_BALL_OUT, .x = x, .y = y});
+}
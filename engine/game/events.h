@@ -0,0 +1,180 @@
+/**
+ * @file events.h
+ * @brief Typed match events, passed out of the simulation through a lock-free ring.
+ * * Things worth telling someone about (a goal, a tackle, a referee call) are
+ * pushed as small fixed-size records into a single-producer /
+ * single-consumer ring that lives in the Scene. The simulation thread is the
+ * only producer; one consumer (the console printer, a stats collector, ...)
+ * drains it, usually from its own thread through an EventPump. Nothing is
+ * formatted on the simulation thread, and nothing is even recorded unless
+ * somebody subscribed to that type of event: with no subscriber, raising an
+ * event is one load and a branch.
+ *
+ * If the consumer falls behind and the ring fills up, new events are dropped
+ * (and counted) rather than stalling the match.
+ *
+ * Example (print the classic console messages while playing):
+ * @code
+ *   events_subscribe(&scene->events, EVENTS_CONSOLE);
+ *   struct EventPump* pump = events_pump_start(&scene->events, match_event_print, stdout);
+ *   ... play ...
+ *   events_pump_stop(pump);
+ * @endcode
+ */
+
+#ifndef ENGINE_GAME_EVENTS_H
+#define ENGINE_GAME_EVENTS_H
+
+#include "core/atomic.h"
+#include "entities/player.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+struct Scene;
+
+/**
+ * @enum MatchEventType
+ */
+typedef enum {
+    EVENT_KICKOFF,      /**< After a goal: `team` kicks off. */
+    EVENT_RESTART,      /**< The kicker (`team`, `kit`) is called to kick off or throw in. */
+    EVENT_GOAL,         /**< Goal given; `value` holds both scores, `team` last touched the ball. */
+    EVENT_OUT,          /**< Ball out at (`x`, `y`), play stops; `team` last touched it. */
+    EVENT_NET_HIT,      /**< Referee saw the ball in a net at (`x`, `y`); `team` scored. */
+    EVENT_BALL_OUT,     /**< Referee saw the ball leave the pitch at (`x`, `y`). */
+    EVENT_POSSESSION,   /**< `team`/`kit` has the ball now; `other_*` had it before (team 0: nobody). */
+    EVENT_TACKLE,       /**< `team`/`kit` went for the ball `other_*` had; `code` is 1 if it won it. */
+    EVENT_VIOLATION,    /**< Rule broken by `team`/`kit`, `code` says which (enum Violation). */
+    EVENT_FULL_TIME,    /**< The clock ran out. */
+    EVENT_TYPE_COUNT
+} MatchEventType;
+
+#define EVENT_BIT(type) (1u << (type))
+#define EVENTS_ALL ((1u << EVENT_TYPE_COUNT) - 1u)
+/** @brief The events the game has always printed to the console. */
+#define EVENTS_CONSOLE (EVENTS_ALL & ~(EVENT_BIT(EVENT_POSSESSION) | EVENT_BIT(EVENT_TACKLE)))
+
+/**
+ * @enum Violation
+ * @brief What the referee caught (see logic/referee.c).
+ */
+enum Violation {
+    VIOLATION_TALENTS,          /**< `value` holds defence, agility, dribbling, shooting and their sum. */
+    VIOLATION_SHOOT_WITHOUT_BALL,
+    VIOLATION_RUN_X,
+    VIOLATION_RUN_Y,
+    VIOLATION_SHOOT_X,
+    VIOLATION_SHOOT_Y,
+    VIOLATION_KICKOFF_HALF      /**< Kick-off not played into the kicker's own half. */
+};
+
+/**
+ * @struct MatchEvent
+ * @brief One event. Which fields mean something depends on `type`.
+ */
+struct MatchEvent {
+    uint32_t tick;          /**< Tick it happened on, counted from the start of the match. */
+    uint8_t type;           /**< MatchEventType */
+    uint8_t code;
+    uint8_t team;           /**< 1 or 2, 0 if nobody. */
+    uint8_t kit;
+    uint8_t other_team;
+    uint8_t other_kit;
+    int32_t value[5];
+    float x, y;
+};
+
+#define EVENT_RING_CAPACITY 256     /**< Must be a power of two. */
+
+/**
+ * @struct EventRing
+ * @brief The queue between the simulation and one consumer.
+ * * `head` is only written by the producer and `tail` only by the consumer,
+ * each on its own cache line; the slots in between belong to whoever the
+ * indices say.
+ */
+struct EventRing {
+    uint32_t head;          /**< Next slot the producer writes. */
+    uint32_t tick;          /**< Producer's clock, stamped on every event. */
+    uint8_t pad0[CACHE_LINE - 2 * sizeof(uint32_t)];
+    uint32_t tail;          /**< Next slot the consumer reads. */
+    uint8_t pad1[CACHE_LINE - sizeof(uint32_t)];
+    uint32_t mask;          /**< Subscribed EVENT_BITs. */
+    uint32_t dropped;       /**< Events lost because the ring was full. */
+    struct MatchEvent slot[EVENT_RING_CAPACITY];
+};
+
+/** @brief Empties the ring and drops every subscription. Nobody may be using it. */
+void events_init(struct EventRing* ring);
+
+/** @brief Sets which event types get recorded (EVENT_BIT()s, 0 for none). Any thread. */
+void events_subscribe(struct EventRing* ring, uint32_t mask);
+
+/** @brief True if events of `type` are being recorded. */
+static inline bool events_wanted(const struct EventRing* ring, MatchEventType type) {
+    return (load_relaxed(&ring->mask) & EVENT_BIT(type)) != 0;
+}
+
+/** @brief Producer side: queues a copy of `event`. Never blocks. */
+void events_push(struct EventRing* ring, const struct MatchEvent* event);
+
+/** @brief Producer side: stamps and queues `event` if anyone wants its type. */
+static inline void event_raise(struct EventRing* ring, struct MatchEvent event) {
+    if (!events_wanted(ring, (MatchEventType)event.type))
+        return;
+    event.tick = ring->tick;
+    events_push(ring, &event);
+}
+
+typedef void (*EventHandler)(const struct MatchEvent* event, void* user);
+
+/**
+ * @brief Consumer side: calls `handler` for every queued event, oldest first.
+ * Only one thread may drain a ring at a time.
+ * @return Number of events handled.
+ */
+size_t events_drain(struct EventRing* ring, EventHandler handler, void* user);
+
+/** @brief Events dropped so far because the ring was full. */
+unsigned long events_dropped(const struct EventRing* ring);
+
+/**
+ * @brief Writes the console text of `event` (with its trailing newline).
+ * @return Length of the text, as snprintf; 0 for events without one.
+ */
+int match_event_format(const struct MatchEvent* event, char* out, size_t len);
+
+/** @brief EventHandler that writes match_event_format() to the FILE* in `file`. */
+void match_event_print(const struct MatchEvent* event, void* file);
+
+struct EventPump;
+
+/**
+ * @brief A thread that keeps draining one ring into a handler.
+ * @return NULL if the thread couldn't be started.
+ */
+struct EventPump* events_pump_start(struct EventRing* ring, EventHandler handler, void* user);
+
+/**
+ * @brief Handles whatever is still queued and stops the thread. Call it once
+ * the producer is done (or between ticks).
+ */
+void events_pump_stop(struct EventPump* pump);
+
+/**
+ * @name Reporting without a Scene
+ * @brief For code that only sees a player or the ball (the referee's
+ * verify_* checks). The event goes to the scene this thread is updating;
+ * scene_advance_clock() and scene_reset() set it, events_bind() does it by hand.
+ */
+///@{
+void events_bind(struct Scene* scene);
+void event_violation(enum Violation violation, const struct Player* player);
+void event_talents(struct Talents talents, int sum);
+void event_net_hit(int team, float x, float y);
+void event_ball_out(float x, float y);
+///@}
+
+#endif
@@ -0,0 +1,264 @@
+#include "match.h"
+#include "match_batch.h"
+#include "replay.h"
+#include "scene.h"
+#include "timestep.h"
+#include "core/clock.h"
+#include "core/log.h"
+#include "core/thread_pool.h"
+#include "entities/team.h"
+#include "logic/referee.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+static pthread_mutex_t profiler_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/** Events the match's scene has to record from its first reset on. */
+static uint32_t match_events(const struct MatchConfig* config) {
+    return config->on_event ? config->events : 0;
+}
+
+/**
+ * @brief Plays the match already set up in `scene` to the final whistle.
+ */
+static void run_match(Scene* scene, const struct MatchConfig* config, struct MatchResult* result) {
+    struct FixedStep step;
+    fixed_step_init(&step, config->tick_rate);
+
+    struct ReplayRecorder* recorder = NULL;
+    if (config->record) {
+        const struct ReplayConfig replay = {.prefix = config->record};
+        recorder = replay_recorder_create(&replay, config->seed,
+                                          config->tick_rate > 0 ? config->tick_rate : SIM_TICK_RATE);
+        if (!recorder)
+            LOG_ERROR(LOG_REPLAY, "can't record to %s", config->record);
+    }
+
+    // the scene was subscribed before its kick-off (match_events)
+    struct EventPump* pump = NULL;
+    if (match_events(config)) {
+        pump = events_pump_start(&scene->events, config->on_event, config->event_user);
+        if (!pump)
+            events_subscribe(&scene->events, 0);
+    }
+    if (config->setup)
+        config->setup(scene, config->setup_user);
+
+    // timed on its own, then merged: several matches may share config->profiler
+    struct Profiler* profiler = config->profiler ? profiler_create() : NULL;
+    scene->profiler = profiler;
+
+    unsigned long ticks = 0;
+    uint64_t hash = SCENE_HASH_SEED;
+    const double start = clock_now_seconds();
+    while (scene->state != STATE_TIMEOUT) {
+        update_scene(scene, step.tick_dt);
+        ticks++;
+        if (config->hash)
+            hash = scene_hash(scene, hash);
+        if (recorder)
+            replay_record(recorder, scene, (uint32_t)ticks);
+    }
+
+    result->seed = config->seed;
+    result->first_score = scene->first_team->score;
+    result->second_score = scene->second_team->score;
+    result->ticks = ticks;
+    result->seconds = clock_now_seconds() - start;
+    result->hash = config->hash ? hash : 0;
+
+    if (profiler) {
+        pthread_mutex_lock(&profiler_lock);
+        profiler_merge(config->profiler, profiler);
+        pthread_mutex_unlock(&profiler_lock);
+        scene->profiler = NULL;
+        profiler_destroy(profiler);
+    }
+    if (pump) {
+        events_pump_stop(pump);
+        events_subscribe(&scene->events, 0);
+        if (events_dropped(&scene->events) > 0)
+            LOG_WARN(LOG_MATCH, "seed %llu: %lu event(s) dropped",
+                     (unsigned long long)config->seed, events_dropped(&scene->events));
+    }
+    if (recorder) {
+        if (replay_recorder_dropped(recorder) > 0)
+            LOG_WARN(LOG_REPLAY, "%s: %lu frame(s) dropped", config->record, replay_recorder_dropped(recorder));
+        replay_recorder_destroy(recorder);
+    }
+}
+
+/** Result of a match that couldn't be played (no memory for its scene). */
+static void no_match(const struct MatchConfig* config, struct MatchResult* result) {
+    memset(result, 0, sizeof(*result));
+    result->seed = config->seed;
+}
+
+void play_match(const struct MatchConfig* config, struct MatchResult* result) {
+    Scene* scene = scene_create(config->team_size, config->seed, match_events(config));
+    if (!scene) {
+        no_match(config, result);
+        return;
+    }
+    run_match(scene, config, result);
+    scene_destroy(scene);
+}
+
+struct MatchJob {
+    const struct MatchConfig* config;
+    struct MatchResult* result;
+    Scene** worker_scenes;  /**< One recycled scene per worker thread. */
+};
+
+static void match_task(void* arg, int worker) {
+    struct MatchJob* job = arg;
+    Scene** scene = &job->worker_scenes[worker];
+
+    // first match on this worker allocates; every later one with the same
+    // team size reuses the block
+    const int team_size = job->config->team_size > 0 ? job->config->team_size : PLAYER_COUNT;
+    if (*scene && (*scene)->team_size != team_size) {
+        scene_destroy(*scene);
+        *scene = NULL;
+    }
+    if (*scene) {
+        events_subscribe(&(*scene)->events, match_events(job->config));
+        scene_reset(*scene, job->config->seed);
+    } else {
+        *scene = scene_create(team_size, job->config->seed, match_events(job->config));
+    }
+
+    if (*scene)
+        run_match(*scene, job->config, job->result);
+    else
+        no_match(job->config, job->result);
+}
+
+int play_matches(const struct MatchConfig* configs, struct MatchResult* results, int count, int threads) {
+    struct MatchJob* jobs = malloc(sizeof(struct MatchJob) * (count > 0 ? count : 1));
+    if (!jobs) return -1;
+
+    struct ThreadPool* pool = thread_pool_create(threads);
+    if (!pool) {
+        free(jobs);
+        return -1;
+    }
+
+    const int workers = thread_pool_size(pool);
+    int used = workers;
+    Scene** worker_scenes = calloc(workers, sizeof(Scene*));
+    if (!worker_scenes) {
+        thread_pool_destroy(pool);
+        free(jobs);
+        return -1;
+    }
+
+    for (int i = 0; i < count; i++) {
+        jobs[i].config = &configs[i];
+        jobs[i].result = &results[i];
+        jobs[i].worker_scenes = worker_scenes;
+        if (thread_pool_submit(pool, match_task, &jobs[i]) != 0) {
+            used = -1;
+            break;
+        }
+    }
+    thread_pool_wait(pool);
+    thread_pool_destroy(pool);
+
+    for (int w = 0; w < workers; w++)
+        scene_destroy(worker_scenes[w]);
+    free(worker_scenes);
+    free(jobs);
+    return used;
+}
+
+void play_matches_lockstep(const struct MatchConfig* configs, struct MatchResult* results, int count) {
+    if (count <= 0) return;
+#ifdef SOCCER_FIXED_POINT
+    // the batch kernels are float SIMD; keep the fixed-point physics instead
+    for (int i = 0; i < count; i++)
+        play_match(&configs[i], &results[i]);
+    return;
+#endif
+
+    struct FixedStep step;
+    fixed_step_init(&step, configs[0].tick_rate);
+
+    const int team_size = configs[0].team_size > 0 ? configs[0].team_size : PLAYER_COUNT;
+    Scene** scenes = calloc(count, sizeof(Scene*));
+    struct MatchBatch* batch = match_batch_create(count, team_size * 2);
+    if (!scenes || !batch) {
+        // not enough memory to batch: fall back to one match at a time
+        free(scenes);
+        match_batch_destroy(batch);
+        for (int i = 0; i < count; i++)
+            play_match(&configs[i], &results[i]);
+        return;
+    }
+
+    for (int i = 0; i < count; i++) {
+        scenes[i] = scene_create(team_size, configs[i].seed, 0);
+        if (!scenes[i]) {
+            for (int k = 0; k < i; k++)
+                scene_destroy(scenes[k]);
+            free(scenes);
+            match_batch_destroy(batch);
+            for (int k = 0; k < count; k++)
+                no_match(&configs[k], &results[k]);
+            return;
+        }
+        if (configs[i].setup)
+            configs[i].setup(scenes[i], configs[i].setup_user);
+        results[i].seed = configs[i].seed;
+        results[i].ticks = 0;
+        results[i].hash = SCENE_HASH_SEED;
+    }
+
+    const double start = clock_now_seconds();
+    int remaining = count;
+    while (remaining > 0) {
+        // per scene: match flow and coaches
+        for (int lane = 0; lane < count; lane++) {
+            Scene* scene = scenes[lane];
+            batch->active[lane] = 0;
+            if (scene->state == STATE_TIMEOUT)
+                continue;
+
+            results[lane].ticks++;
+            scene_store_previous_positions(scene);
+            if (scene_advance_clock(scene, step.tick_dt)) {
+                scene_run_coaches(scene);
+                match_batch_load(batch, lane, scene);
+                continue;   // hashed once the batch has stepped it
+            } else if (scene->state == STATE_TIMEOUT) {
+                results[lane].seconds = clock_now_seconds() - start;
+                remaining--;
+            }
+            if (configs[lane].hash)
+                results[lane].hash = scene_hash(scene, results[lane].hash);
+        }
+
+        // all matches at once: physics and the ball's sweep; then the referee, per scene
+        match_batch_step(batch, step.tick_dt);
+
+        for (int lane = 0; lane < count; lane++) {
+            if (!batch->active[lane]) continue;
+            Scene* scene = scenes[lane];
+            match_batch_store(batch, lane, scene);
+            scene_apply_referee(scene, referee(scene));
+            if (configs[lane].hash)
+                results[lane].hash = scene_hash(scene, results[lane].hash);
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (!configs[i].hash) results[i].hash = 0;
+        results[i].first_score = scenes[i]->first_team->score;
+        results[i].second_score = scenes[i]->second_team->score;
+        scene_destroy(scenes[i]);
+    }
+    match_batch_destroy(batch);
+    free(scenes);
+}
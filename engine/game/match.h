@@ -0,0 +1,75 @@
+/**
+ * @file match.h
+ * @brief Plays whole matches headlessly, one at a time or many in parallel.
+ * * Every match owns its Scene, teams, ball and random generator, so matches
+ * share nothing and can run on as many threads as there are cores.
+ */
+
+#ifndef ENGINE_GAME_MATCH_H
+#define ENGINE_GAME_MATCH_H
+
+#include "game/events.h"
+#include "game/profiler.h"
+
+#include <stdint.h>
+
+struct Scene;
+
+/**
+ * @struct MatchConfig
+ * @brief How to play one match.
+ */
+struct MatchConfig {
+    uint64_t seed;      /**< Seed for the match's random generator. */
+    int tick_rate;      /**< Simulation ticks per second (<= 0 uses SIM_TICK_RATE). */
+    int team_size;      /**< Players per team (<= 0 uses PLAYER_COUNT). */
+    const char* record; /**< Replay file prefix (see game/replay.h), or NULL to not record. */
+    uint32_t events;        /**< EVENT_BIT()s to report (see game/events.h), 0 for none. */
+    EventHandler on_event;  /**< Gets each reported event, on a thread of its own. */
+    void* event_user;       /**< Passed to on_event. */
+    struct Profiler* profiler; /**< Phase timings of the match are merged into this (see game/profiler.h), or NULL. */
+    int hash;           /**< Non-zero: fingerprint the match in MatchResult.hash (costs a little per tick). */
+    void (*setup)(struct Scene* scene, void* user); /**< Called on the scene before the first tick (e.g. to swap coaches), or NULL. */
+    void* setup_user;   /**< Passed to setup. */
+};
+
+/**
+ * @struct MatchResult
+ * @brief What happened in one match.
+ */
+struct MatchResult {
+    uint64_t seed;
+    unsigned int first_score;
+    unsigned int second_score;
+    unsigned long ticks;    /**< Simulation ticks until the final whistle. */
+    double seconds;         /**< Wall-clock time it took to simulate. */
+    uint64_t hash;          /**< scene_hash after every tick, if MatchConfig.hash was set; else 0. */
+};
+
+/**
+ * @brief Plays one full match on the calling thread.
+ */
+void play_match(const struct MatchConfig* config, struct MatchResult* result);
+
+/**
+ * @brief Plays `count` independent matches on a pool of worker threads.
+ * * `results[i]` receives the outcome of `configs[i]`.
+ * @param threads Worker count; <= 0 uses one per CPU.
+ * @return Number of worker threads used, or -1 if the pool couldn't start.
+ */
+int play_matches(const struct MatchConfig* configs, struct MatchResult* results, int count, int threads);
+
+/**
+ * @brief Plays `count` matches in lockstep on the calling thread, one
+ * MatchBatch lane each (see game/match_batch.h).
+ * * Match flow, coaches, set-pieces and the referee run per scene; the
+ * physics and the sweep of the ball's path run batched. The referee sees
+ * the same scene it would see in play_match. All matches use the tick
+ * rate and team size of `configs[0]`. Matches played this way are not
+ * recorded, report no events and are not profiled.
+ * Fixed-point builds (see core/fixed.h) play them one after another with
+ * play_match instead, as the batch kernels are float only.
+ */
+void play_matches_lockstep(const struct MatchConfig* configs, struct MatchResult* results, int count);
+
+#endif
@@ -0,0 +1,477 @@
+#include "match_batch.h"
+#include "scene.h"
+#include "simd.h"
+#include "sweep.h"
+#include "entities/ball.h"
+#include "entities/player.h"
+#include "logic/referee.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** fixed_from_float (core/fixed.h), lane by lane; `a` must be in range. */
+static inline vi vf_to_fixed(vf a) {
+    const vf scaled = vf_mul(a, vf_set1((float)FIXED_ONE));
+    const vf half = vf_select(vm_lt(scaled, vf_set1(0.0f)), vf_set1(-0.5f), vf_set1(0.5f));
+    return vi_trunc(vf_add(scaled, half));
+}
+
+/** fixed_to_float, lane by lane. */
+static inline vf vi_to_float(vi a) {
+    return vf_div(vi_to_vf(a), vf_set1((float)FIXED_ONE));
+}
+
+/** Every lane count is padded to this, whatever VW the build uses. */
+#define BATCH_ALIGN 8
+
+int match_batch_simd_width(void) {
+    return VW;
+}
+
+/* -------------------------------------------------------------------------
+ * Allocation
+ * ------------------------------------------------------------------------- */
+struct MatchBatch* match_batch_create(int matches, int players) {
+    if (matches <= 0 || players <= 0)
+        return NULL;
+
+    struct MatchBatch* b = calloc(1, sizeof(struct MatchBatch));
+    if (!b) return NULL;
+
+    b->matches = matches;
+    b->lanes = (matches + BATCH_ALIGN - 1) / BATCH_ALIGN * BATCH_ALIGN;
+    b->players = players;
+
+    const size_t per_player = (size_t)players * b->lanes;
+    const size_t per_match = (size_t)b->lanes;
+
+    b->px = calloc(per_player, sizeof(float));
+    b->py = calloc(per_player, sizeof(float));
+    b->pvx = calloc(per_player, sizeof(float));
+    b->pvy = calloc(per_player, sizeof(float));
+    b->pr = calloc(per_player, sizeof(float));
+    b->intercepting = calloc(per_player, sizeof(int32_t));
+    b->touching = calloc(per_player, sizeof(int32_t));
+    b->push_x = calloc(per_player, sizeof(fixed));
+    b->push_y = calloc(per_player, sizeof(fixed));
+    b->defence = calloc(per_player, sizeof(int32_t));
+    b->dribbling = calloc(per_player, sizeof(int32_t));
+    b->team = calloc(per_player, sizeof(int32_t));
+
+    b->bx = calloc(per_match, sizeof(float));
+    b->by = calloc(per_match, sizeof(float));
+    b->bvx = calloc(per_match, sizeof(float));
+    b->bvy = calloc(per_match, sizeof(float));
+    b->br = calloc(per_match, sizeof(float));
+    b->bx0 = calloc(per_match, sizeof(float));
+    b->by0 = calloc(per_match, sizeof(float));
+    b->bx1 = calloc(per_match, sizeof(float));
+    b->by1 = calloc(per_match, sizeof(float));
+    b->possessor = calloc(per_match, sizeof(int32_t));
+    b->last_team = calloc(per_match, sizeof(int32_t));
+    b->active = calloc(per_match, sizeof(int32_t));
+    b->sweep = calloc(per_match, sizeof(struct Sweep));
+    b->rng = calloc(per_match, sizeof(struct Rng));
+
+    if (!b->px || !b->py || !b->pvx || !b->pvy || !b->pr || !b->intercepting ||
+        !b->touching || !b->push_x || !b->push_y || !b->defence || !b->dribbling || !b->team ||
+        !b->bx || !b->by || !b->bvx || !b->bvy || !b->br ||
+        !b->bx0 || !b->by0 || !b->bx1 || !b->by1 || !b->possessor ||
+        !b->last_team || !b->active || !b->sweep || !b->rng) {
+        match_batch_destroy(b);
+        return NULL;
+    }
+
+    if (players >= GRID_SEPARATE_MIN_SLOTS) {
+        const int team_size = (players + 1) / 2;
+        const size_t size = player_block_bytes(team_size) + spatial_grid_bytes(PLAYER_BLOCK_CAPACITY(team_size));
+        b->grid_memory = calloc(1, size);
+        if (!b->grid_memory) {
+            match_batch_destroy(b);
+            return NULL;
+        }
+        struct Arena arena;
+        arena_init(&arena, b->grid_memory, size);
+        player_block_init(&b->lane, &arena, team_size);
+        spatial_grid_init(&b->grid, &arena, b->lane.capacity);
+        b->lane.count = players;
+        b->lane.view = NULL;    // every slot is a player
+    }
+
+    for (int lane = 0; lane < b->lanes; lane++)
+        b->possessor[lane] = -1;
+    return b;
+}
+
+void match_batch_destroy(struct MatchBatch* b) {
+    if (!b) return;
+    free(b->px); free(b->py); free(b->pvx); free(b->pvy); free(b->pr);
+    free(b->intercepting); free(b->touching); free(b->push_x); free(b->push_y);
+    free(b->defence); free(b->dribbling); free(b->team);
+    free(b->bx); free(b->by); free(b->bvx); free(b->bvy); free(b->br);
+    free(b->bx0); free(b->by0); free(b->bx1); free(b->by1);
+    free(b->possessor); free(b->last_team);
+    free(b->active); free(b->sweep); free(b->rng);
+    free(b->grid_memory);
+    free(b);
+}
+
+/* -------------------------------------------------------------------------
+ * Scene <-> lane
+ * ------------------------------------------------------------------------- */
+void match_batch_load(struct MatchBatch* b, int lane, const struct Scene* scene) {
+    const struct PlayerBlock* block = &scene->players;
+    const struct Ball* ball = scene->ball;
+
+    b->possessor[lane] = -1;
+    for (int s = 0; s < b->players; s++) {
+        const size_t i = (size_t)s * b->lanes + lane;
+        const struct Player* p = s < block->count ? block->view[s] : NULL;
+        if (!p) {
+            b->pr[i] = 0.0f;
+            b->intercepting[i] = 0;
+            continue;
+        }
+        b->px[i] = p->position.x;
+        b->py[i] = p->position.y;
+        b->pvx[i] = p->velocity.x;
+        b->pvy[i] = p->velocity.y;
+        b->pr[i] = p->radius;
+        b->intercepting[i] = (p->state == INTERCEPTING);
+        b->defence[i] = p->talents.defence;
+        b->dribbling[i] = p->talents.dribbling;
+        b->team[i] = p->team;
+        if (p == ball->possessor)
+            b->possessor[lane] = s;
+    }
+
+    b->bx[lane] = ball->position.x;
+    b->by[lane] = ball->position.y;
+    b->bvx[lane] = ball->velocity.x;
+    b->bvy[lane] = ball->velocity.y;
+    b->br[lane] = ball->radius;
+    b->last_team[lane] = ball->last_team;
+    b->rng[lane] = scene->rng;
+    b->active[lane] = 1;
+}
+
+void match_batch_store(const struct MatchBatch* b, int lane, struct Scene* scene) {
+    const struct PlayerBlock* block = &scene->players;
+    struct Ball* ball = scene->ball;
+
+    for (int s = 0; s < b->players && s < block->count; s++) {
+        struct Player* p = block->view[s];
+        if (!p) continue;
+        const size_t i = (size_t)s * b->lanes + lane;
+        p->position.x = b->px[i];
+        p->position.y = b->py[i];
+    }
+
+    ball->position.x = b->bx[lane];
+    ball->position.y = b->by[lane];
+    ball->velocity.x = b->bvx[lane];
+    ball->velocity.y = b->bvy[lane];
+    ball->last_team = b->last_team[lane];
+    const int owner = b->possessor[lane];
+    ball->possessor = (owner >= 0 && owner < block->count) ? block->view[owner] : NULL;
+    scene->rng = b->rng[lane];
+    scene->ball_sweep = b->sweep[lane];
+}
+
+/* -------------------------------------------------------------------------
+ * Kernels
+ * ------------------------------------------------------------------------- */
+
+/** touching = intercepting && overlapping the ball, for every slot of every lane. */
+static void kernel_contact(struct MatchBatch* b) {
+    const int L = b->lanes;
+    for (int s = 0; s < b->players; s++) {
+        const size_t row = (size_t)s * L;
+        for (int lane = 0; lane < L; lane += VW) {
+            const size_t i = row + lane;
+            const vf dx = vf_sub(vf_load(&b->px[i]), vf_load(&b->bx[lane]));
+            const vf dy = vf_sub(vf_load(&b->py[i]), vf_load(&b->by[lane]));
+            const vf reach = vf_add(vf_load(&b->pr[i]), vf_load(&b->br[lane]));
+            const vf dist_sq = vf_add(vf_mul(dx, dx), vf_mul(dy, dy));
+            vm hit = vm_le(dist_sq, vf_mul(reach, reach));
+            hit = vm_and(hit, vm_load_i32(&b->intercepting[i]));
+            hit = vm_and(hit, vm_load_i32(&b->active[lane]));
+            vm_store_i32(&b->touching[i], hit);
+        }
+    }
+}
+
+/** Same rules as tackle() in possession.c, for one lane. */
+static void lane_tackle(struct MatchBatch* b, int lane, int slot) {
+    const int L = b->lanes;
+    const size_t i = (size_t)slot * L + lane;
+    const int owner = b->possessor[lane];
+
+    if (owner >= 0) {
+        const int defence_score = b->defence[i];
+        const int sum = defence_score + b->dribbling[(size_t)owner * L + lane];
+        const int random_roll = (int)rng_below(&b->rng[lane], (uint32_t)sum);
+        if (random_roll >= defence_score)
+            return;
+    }
+    b->possessor[lane] = slot;
+    b->bvx[lane] = b->pvx[i];
+    b->bvy[lane] = b->pvy[i];
+}
+
+/** Tackles are rare, order-dependent and random: resolve them per lane. */
+static void resolve_possession(struct MatchBatch* b) {
+    const int L = b->lanes;
+    const int half = b->players / 2;
+    for (int lane = 0; lane < b->matches; lane++) {
+        if (!b->active[lane]) continue;
+        // red 0, blue 0, red 1, ... exactly like update_ball_possessor
+        for (int k = 0; k < half; k++) {
+            if (b->touching[(size_t)k * L + lane])
+                lane_tackle(b, lane, k);
+            if (b->touching[(size_t)(half + k) * L + lane])
+                lane_tackle(b, lane, half + k);
+        }
+        for (int s = 2 * half; s < b->players; s++)
+            if (b->touching[(size_t)s * L + lane])
+                lane_tackle(b, lane, s);
+        if (b->possessor[lane] >= 0)
+            b->last_team[lane] = b->team[(size_t)b->possessor[lane] * L + lane];
+    }
+}
+
+/** position += velocity * dt. */
+static void kernel_players(struct MatchBatch* b, float dt) {
+    const int L = b->lanes;
+    const vf vdt = vf_set1(dt);
+
+    for (int s = 0; s < b->players; s++) {
+        const size_t row = (size_t)s * L;
+        for (int lane = 0; lane < L; lane += VW) {
+            const size_t i = row + lane;
+            const vm on = vm_load_i32(&b->active[lane]);
+            const vf x0 = vf_load(&b->px[i]);
+            const vf y0 = vf_load(&b->py[i]);
+            const vf x = vf_add(x0, vf_mul(vf_load(&b->pvx[i]), vdt));
+            const vf y = vf_add(y0, vf_mul(vf_load(&b->pvy[i]), vdt));
+            vf_store(&b->px[i], vf_select(on, x, x0));
+            vf_store(&b->py[i], vf_select(on, y, y0));
+        }
+    }
+}
+
+/**
+ * Big teams: one lane at a time, through the grid, with the scenes' own code.
+ * The pushes add up exactly, so this gives the same result as the every-pair
+ * kernel below would.
+ */
+static void separate_lanes_with_grid(struct MatchBatch* b) {
+    const int L = b->lanes;
+    struct PlayerBlock* block = &b->lane;
+
+    for (int lane = 0; lane < b->matches; lane++) {
+        if (!b->active[lane]) continue;
+        for (int s = 0; s < b->players; s++) {
+            const size_t i = (size_t)s * L + lane;
+            block->x[s] = b->px[i];
+            block->y[s] = b->py[i];
+            block->radius[s] = b->pr[i];
+        }
+        spatial_grid_build(&b->grid, block->x, block->y, NULL, 0, b->players);
+        player_block_separate(block, &b->grid);
+        for (int s = 0; s < b->players; s++) {
+            const size_t i = (size_t)s * L + lane;
+            b->px[i] = block->x[s];
+            b->py[i] = block->y[s];
+        }
+    }
+}
+
+/**
+ * Pushes overlapping players apart, every pair, the same way as push_pair in
+ * player_block.c: each push is rounded to fixed point and summed as an
+ * integer, so the totals match player_block_separate's bit for bit.
+ * Empty slots have radius 0 and are left out.
+ */
+static void kernel_separate(struct MatchBatch* b) {
+    if (b->grid_memory) {
+        separate_lanes_with_grid(b);
+        return;
+    }
+
+    const int L = b->lanes;
+    const vf zero = vf_set1(0.0f);
+    const vf one = vf_set1(1.0f);
+    const vf half = vf_set1(0.5f);
+
+    memset(b->push_x, 0, (size_t)b->players * L * sizeof(fixed));
+    memset(b->push_y, 0, (size_t)b->players * L * sizeof(fixed));
+
+    for (int si = 0; si < b->players; si++) {
+        for (int sj = si + 1; sj < b->players; sj++) {
+            for (int lane = 0; lane < L; lane += VW) {
+                const size_t i = (size_t)si * L + lane;
+                const size_t j = (size_t)sj * L + lane;
+                const vf ri = vf_load(&b->pr[i]);
+                const vf rj = vf_load(&b->pr[j]);
+                const vf dx = vf_sub(vf_load(&b->px[j]), vf_load(&b->px[i]));
+                const vf dy = vf_sub(vf_load(&b->py[j]), vf_load(&b->py[i]));
+                const vf reach = vf_add(ri, rj);
+                const vf d2 = vf_add(vf_mul(dx, dx), vf_mul(dy, dy));
+                vm hit = vm_lt(d2, vf_mul(reach, reach));
+                hit = vm_and(hit, vm_and(vm_gt(ri, zero), vm_gt(rj, zero)));
+                hit = vm_and(hit, vm_load_i32(&b->active[lane]));
+
+                const vf d = vf_sqrt(d2);
+                const vm apart = vm_gt(d, zero);
+                const vf nx = vf_select(apart, vf_div(dx, d), one);
+                const vf ny = vf_select(apart, vf_div(dy, d), zero);
+                const vf h = vf_select(hit, vf_mul(half, vf_sub(reach, d)), zero);
+                const vi px = vf_to_fixed(vf_mul(nx, h));
+                const vi py = vf_to_fixed(vf_mul(ny, h));
+                vi_store(&b->push_x[i], vi_sub(vi_load(&b->push_x[i]), px));
+                vi_store(&b->push_y[i], vi_sub(vi_load(&b->push_y[i]), py));
+                vi_store(&b->push_x[j], vi_add(vi_load(&b->push_x[j]), px));
+                vi_store(&b->push_y[j], vi_add(vi_load(&b->push_y[j]), py));
+            }
+        }
+    }
+
+    for (size_t k = 0; k < (size_t)b->players * L; k += VW) {
+        vf_store(&b->px[k], vf_add(vf_load(&b->px[k]), vi_to_float(vi_load(&b->push_x[k]))));
+        vf_store(&b->py[k], vf_add(vf_load(&b->py[k]), vi_to_float(vi_load(&b->push_y[k]))));
+    }
+}
+
+/** Keep every body inside the window. */
+static void kernel_clamp(struct MatchBatch* b) {
+    const int L = b->lanes;
+    const vf width = vf_set1((float)SCREEN_WIDTH);
+    const vf height = vf_set1((float)SCREEN_HEIGHT);
+
+    for (int s = 0; s < b->players; s++) {
+        const size_t row = (size_t)s * L;
+        for (int lane = 0; lane < L; lane += VW) {
+            const size_t i = row + lane;
+            const vm on = vm_load_i32(&b->active[lane]);
+            const vf r = vf_load(&b->pr[i]);
+            const vf x0 = vf_load(&b->px[i]);
+            const vf y0 = vf_load(&b->py[i]);
+            vf x = vf_select(vm_lt(x0, r), r, x0);
+            vf y = vf_select(vm_lt(y0, r), r, y0);
+            const vf max_x = vf_sub(width, r);
+            const vf max_y = vf_sub(height, r);
+            x = vf_select(vm_gt(x, max_x), max_x, x);
+            y = vf_select(vm_gt(y, max_y), max_y, y);
+            vf_store(&b->px[i], vf_select(on, x, x0));
+            vf_store(&b->py[i], vf_select(on, y, y0));
+        }
+    }
+}
+
+/** Ball integration, friction, stopping and bouncing off the window edges. */
+static void kernel_ball(struct MatchBatch* b, float dt, float friction) {
+    const vf vdt = vf_set1(dt);
+    const vf vfriction = vf_set1(friction);
+    const vf zero = vf_set1(0.0f);
+    const vf stop_sq = vf_set1(10.0f * 10.0f);
+    const vf width = vf_set1((float)SCREEN_WIDTH);
+    const vf height = vf_set1((float)SCREEN_HEIGHT);
+
+    for (int lane = 0; lane < b->lanes; lane += VW) {
+        const vm on = vm_load_i32(&b->active[lane]);
+        const vf r = vf_load(&b->br[lane]);
+        const vf x0 = vf_load(&b->bx[lane]);
+        const vf y0 = vf_load(&b->by[lane]);
+        const vf vx0 = vf_load(&b->bvx[lane]);
+        const vf vy0 = vf_load(&b->bvy[lane]);
+
+        vf x = vf_add(x0, vf_mul(vx0, vdt));
+        vf y = vf_add(y0, vf_mul(vy0, vdt));
+        // the referee looks at the whole flight, bounces would bend it
+        vf_store(&b->bx0[lane], x0);
+        vf_store(&b->by0[lane], y0);
+        vf_store(&b->bx1[lane], vf_select(on, x, x0));
+        vf_store(&b->by1[lane], vf_select(on, y, y0));
+        vf vx = vf_mul(vx0, vfriction);
+        vf vy = vf_mul(vy0, vfriction);
+
+        // finally the ball stops
+        const vm slow = vm_lt(vf_add(vf_mul(vx, vx), vf_mul(vy, vy)), stop_sq);
+        vx = vf_select(slow, zero, vx);
+        vy = vf_select(slow, zero, vy);
+
+        // bounce off the window edges
+        vm m = vm_lt(vf_sub(x, r), zero);
+        x = vf_select(m, r, x);
+        vx = vf_select(m, vf_neg(vx), vx);
+        m = vm_gt(vf_add(x, r), width);
+        x = vf_select(m, vf_sub(width, r), x);
+        vx = vf_select(m, vf_neg(vx), vx);
+        m = vm_lt(vf_sub(y, r), zero);
+        y = vf_select(m, r, y);
+        vy = vf_select(m, vf_neg(vy), vy);
+        m = vm_gt(vf_add(y, r), height);
+        y = vf_select(m, vf_sub(height, r), y);
+        vy = vf_select(m, vf_neg(vy), vy);
+
+        vf_store(&b->bx[lane], vf_select(on, x, x0));
+        vf_store(&b->by[lane], vf_select(on, y, y0));
+        vf_store(&b->bvx[lane], vf_select(on, vx, vx0));
+        vf_store(&b->bvy[lane], vf_select(on, vy, vy0));
+    }
+}
+
+/** Ball touching or past any of the four pitch lines, give or take a pixel of rounding. */
+static vm near_lines(vf x, vf y, vf r) {
+    r = vf_add(r, vf_set1(1.0f));
+    const vm left = vm_le(vf_sub(x, r), vf_set1(PITCH_X));
+    const vm right = vm_ge(vf_add(x, r), vf_set1(PITCH_X + PITCH_W));
+    const vm top = vm_le(vf_sub(y, r), vf_set1(PITCH_Y));
+    const vm bottom = vm_ge(vf_add(y, r), vf_set1(PITCH_Y + PITCH_H));
+    return vm_or(vm_or(left, right), vm_or(top, bottom));
+}
+
+/**
+ * scene->ball_sweep for every lane: what the ball flew over this step (see
+ * game/sweep.h). A ball that stays clear of every line all step can't cross
+ * one or touch a post, so the vector pass picks the lanes where it started
+ * or ended near one and sweep_ball looks at those.
+ */
+static void kernel_sweep(struct MatchBatch* b) {
+    int32_t near[BATCH_ALIGN];
+
+    for (int lane = 0; lane < b->lanes; lane += BATCH_ALIGN) {
+        for (int k = 0; k < BATCH_ALIGN; k += VW) {
+            const int l = lane + k;
+            const vf r = vf_load(&b->br[l]);
+            const vm start = near_lines(vf_load(&b->bx0[l]), vf_load(&b->by0[l]), r);
+            const vm end = near_lines(vf_load(&b->bx1[l]), vf_load(&b->by1[l]), r);
+            vm_store_i32(&near[k], vm_or(start, end));
+        }
+        for (int k = 0; k < BATCH_ALIGN; k++) {
+            const int l = lane + k;
+            if (!b->active[l]) continue;
+            const struct Vec2 from = {b->bx0[l], b->by0[l]};
+            const struct Vec2 to = {b->bx1[l], b->by1[l]};
+            b->sweep[l] = near[k] ? sweep_ball(from, to, b->br[l])
+                                  : (struct Sweep){.kind = SWEEP_NONE, .t = 1.0f, .point = to};
+        }
+    }
+}
+
+void match_batch_step(struct MatchBatch* b, float dt) {
+    if (b->friction_dt != dt) {
+        b->friction_dt = dt;
+        b->friction = ball_friction_per_tick(dt);
+    }
+
+    kernel_contact(b);
+    resolve_possession(b);
+    kernel_players(b, dt);
+    kernel_separate(b);
+    kernel_clamp(b);
+    kernel_ball(b, dt, b->friction);
+    kernel_sweep(b);
+}
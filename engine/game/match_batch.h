@@ -0,0 +1,101 @@
+/**
+ * @file match_batch.h
+ * @brief Steps the physics of many matches at once, one match per SIMD lane.
+ * * A default 6v6 scene only has 12 players and one ball, which leaves most of a
+ * vector unit idle. A MatchBatch stores K scenes "lane-major": for every
+ * player slot there is one array holding that player's value in each of the
+ * K matches, so one AVX2 instruction advances the same player in 8 matches
+ * (4 with NEON on AArch64, 1 with the portable fallback).
+ *
+ * match_batch_step() covers everything update_and_verify_scene_states does
+ * after the coaches have run: ball contact and tackles, integration, pushing
+ * overlapping players apart, pitch clamping, friction, bouncing off the
+ * window edges, and sweeping the ball's path for goals and outs. Coaches
+ * and the referee still run per scene through the Player* API; use
+ * match_batch_load() / match_batch_store() around them, or let
+ * play_matches_lockstep() (game/match.h) do the whole dance.
+ */
+
+#ifndef ENGINE_GAME_MATCH_BATCH_H
+#define ENGINE_GAME_MATCH_BATCH_H
+
+#include <stdint.h>
+#include "core/rng.h"
+#include "game/player_block.h"
+#include "game/spatial_grid.h"
+
+struct Scene;
+struct Sweep;
+
+/** Lanes per vector register for the kernel compiled into this build. */
+int match_batch_simd_width(void);
+
+/**
+ * @struct MatchBatch
+ * @brief Lane-major physics state of K matches.
+ * Per-player arrays are indexed `[slot * lanes + lane]`, per-match arrays `[lane]`.
+ */
+struct MatchBatch {
+    int matches;        /**< Lanes holding a match (K). */
+    int lanes;          /**< K rounded up to a multiple of 8; the rest is padding. */
+    int players;        /**< Player slots per match (both teams). */
+
+    float* px;          /**< Player x, y, velocity and radius. */
+    float* py;
+    float* pvx;
+    float* pvy;
+    float* pr;
+    int32_t* intercepting;  /**< 1 if the player is INTERCEPTING. */
+    int32_t* touching;      /**< Scratch: 1 if the player touched the ball this step. */
+    fixed* push_x;          /**< Scratch: how far separation moves the player this step, in fixed point. */
+    fixed* push_y;
+    int32_t* defence;       /**< Talents used to resolve tackles. */
+    int32_t* dribbling;
+    int32_t* team;          /**< 1 or 2. */
+
+    float* bx;          /**< Ball x, y, velocity and radius. */
+    float* by;
+    float* bvx;
+    float* bvy;
+    float* br;
+    float* bx0;         /**< Scratch: ball centre at the start of the step, */
+    float* by0;
+    float* bx1;         /**< and where it flew to, before bouncing off the window edges. */
+    float* by1;
+    int32_t* possessor; /**< Slot of the player holding the ball, or -1. */
+    int32_t* last_team; /**< Team that last touched the ball. */
+
+    int32_t* active;    /**< 1 if the lane should be stepped this tick. */
+    struct Sweep* sweep; /**< After a step: what the ball's path crossed (see game/sweep.h). */
+    struct Rng* rng;    /**< Each lane's copy of its scene's generator. */
+
+    float friction_dt;  /**< Tick length `friction` was worked out for. */
+    float friction;     /**< ball_friction_per_tick(friction_dt) (see game/scene.h). */
+
+    /** From GRID_SEPARATE_MIN_SLOTS players on, separation runs one lane at a
+     * time through a grid, on a copy of the lane in `lane`; else these are unused. */
+    void* grid_memory;
+    struct PlayerBlock lane;
+    struct SpatialGrid grid;
+};
+
+/**
+ * @brief Allocates a batch for `matches` matches of `players` slots each.
+ * @return NULL on allocation failure.
+ */
+struct MatchBatch* match_batch_create(int matches, int players);
+void match_batch_destroy(struct MatchBatch* batch);
+
+/** @brief Copies a scene's players, ball and generator into a lane. */
+void match_batch_load(struct MatchBatch* batch, int lane, const struct Scene* scene);
+
+/** @brief Copies a lane's results, ball_sweep included, back into its scene. */
+void match_batch_store(const struct MatchBatch* batch, int lane, struct Scene* scene);
+
+/**
+ * @brief Advances every active lane by one tick of `dt` seconds.
+ * Inactive lanes are left untouched, their `sweep` included.
+ */
+void match_batch_step(struct MatchBatch* batch, float dt);
+
+#endif
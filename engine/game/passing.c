@@ -0,0 +1,131 @@
+#include "passing.h"
+#include "perception.h"
+#include "scene.h"
+#include "simd.h"
+#include "entities/player.h"
+
+#include <math.h>
+
+/* one team's slots, rounded up to whole vectors */
+#define OPPONENTS_MAX ((MAX_TEAM_SIZE + 7) & ~7)
+
+/*
+ * Ball travel time. With per-second decay k the ball covers
+ *   s(t) = v0 / k * (1 - e^(-k t))
+ * so it never gets further than range = v0 / k, and reaches s < range at
+ *   t(s) = -ln(1 - s / range) / k
+ */
+static float ball_time(float s, float range, float k) {
+    return s < range ? -log1pf(-s / range) / k : INFINITY;
+}
+
+/* true if a belongs before b */
+static bool better(const struct PassOption* a, const struct PassOption* b) {
+    if (a->open != b->open) return a->open;
+    return a->margin > b->margin;
+}
+
+/*
+ * One lane against every opponent, VW at a time. For each opponent: how far
+ * along the lane (px from the carrier) it gets closest, and how long it needs
+ * to run within `clearance` of that point. Padding slots have no speed and
+ * get run = INFINITY. Returns the smallest run.
+ */
+static float lane_runs(const float* ox, const float* oy, const float* speed, int count,
+                       float dx, float dy, float inv_len2, float length, float clearance,
+                       float* run, float* along) {
+    const vf vdx = vf_set1(dx), vdy = vf_set1(dy);
+    const vf zero = vf_set1(0.0f), one = vf_set1(1.0f), inf = vf_set1(INFINITY);
+    const vf slowest = vf_set1(1e-6f);
+    vf fastest = inf;
+    for (int j = 0; j < count; j += VW) {
+        const vf x = vf_load(ox + j), y = vf_load(oy + j), v = vf_load(speed + j);
+        vf t = vf_mul(vf_add(vf_mul(x, vdx), vf_mul(y, vdy)), vf_set1(inv_len2));
+        t = vf_select(vm_lt(t, zero), zero, vf_select(vm_gt(t, one), one, t));
+        const vf cx = vf_sub(vf_mul(t, vdx), x), cy = vf_sub(vf_mul(t, vdy), y);
+        vf reach = vf_sub(vf_sqrt(vf_add(vf_mul(cx, cx), vf_mul(cy, cy))), vf_set1(clearance));
+        reach = vf_select(vm_lt(reach, zero), zero, reach);
+        vf r = vf_div(reach, vf_select(vm_lt(v, slowest), slowest, v));
+        r = vf_select(vm_gt(v, zero), r, inf);
+        vf_store(run + j, r);
+        vf_store(along + j, vf_mul(t, vf_set1(length)));
+        fastest = vf_select(vm_lt(r, fastest), r, fastest);
+    }
+    float lanes[VW];
+    vf_store(lanes, fastest);
+    float best = INFINITY;
+    for (int i = 0; i < VW; i++)
+        best = lanes[i] < best ? lanes[i] : best;
+    return best;
+}
+
+int passing_rank(const struct Scene* scene, const struct Player* carrier,
+                 struct PassOption* out, int capacity) {
+    const struct Perception* per = &scene->perception;
+    const struct PlayerBlock* block = &scene->players;
+    const int from = player_block_slot(block, carrier);
+    if (from < 0 || capacity <= 0) return 0;
+
+    const int half = per->count / 2;
+    const int mates = from < half ? 0 : half;   // first slot of the carrier's team
+    const int opponents = from < half ? half : 0;
+    const float ax = per->x[from], ay = per->y[from];
+
+    const float v0 = MAX_BALL_VELOCITY * carrier->talents.shooting / MAX_TALENT_PER_SKILL;
+    const float k = -logf(FRICTION) * FRICTION_REFERENCE_RATE;
+    const float range = v0 / k;
+    const float clearance = PLAYER_RADIUS + BALL_RADIUS;
+
+    // opponents relative to the carrier, padded to whole vectors with speed 0
+    float ox[OPPONENTS_MAX], oy[OPPONENTS_MAX], speed[OPPONENTS_MAX];
+    float run[OPPONENTS_MAX], along[OPPONENTS_MAX];
+    const int padded = (half + VW - 1) / VW * VW;
+    for (int j = 0; j < padded; j++) {
+        const bool real = j < half;
+        ox[j] = real ? per->x[opponents + j] - ax : 0.0f;
+        oy[j] = real ? per->y[opponents + j] - ay : 0.0f;
+        speed[j] = real ? per->max_speed[opponents + j] : 0.0f;
+    }
+
+    int n = 0;
+    for (int r = mates; r < mates + half; r++) {
+        if (r == from || !block->view[r]) continue;
+
+        const float dx = per->x[r] - ax, dy = per->y[r] - ay;
+        const float len2 = dx * dx + dy * dy;
+        const float inv_len2 = len2 > 0.0f ? 1.0f / len2 : 0.0f;
+        const float length = sqrtf(len2);
+        const float arrival = ball_time(length, range, k);
+
+        // The ball is at every point of the lane by `arrival`, so an opponent
+        // with run - arrival above the best margin can't lower it, and the
+        // margin is at most the smallest run. Only opponents near the lane
+        // pay for a logarithm. On a lane longer than the ball's range, the
+        // first opponent past the range cuts it off for good.
+        const float fastest = lane_runs(ox, oy, speed, padded, dx, dy, inv_len2, length,
+                                        clearance, run, along);
+        float margin = INFINITY;
+        for (int j = 0; j < half && margin > -INFINITY; j++) {
+            if (!(speed[j] > 0.0f) || run[j] - arrival > fminf(margin, fastest)) continue;
+            margin = fminf(margin, run[j] - ball_time(along[j], range, k));
+        }
+
+        struct PassOption option = {
+            .receiver = block->view[r],
+            .margin = margin,
+            .arrival = arrival,
+            .length = length,
+        };
+        option.open = isfinite(option.arrival) && margin > 0.0f;
+
+        // insertion sort, keeping the best `capacity`
+        int at = n < capacity ? n : capacity;
+        while (at > 0 && better(&option, &out[at - 1])) {
+            if (at < capacity) out[at] = out[at - 1];
+            at--;
+        }
+        if (at < capacity) out[at] = option;
+        if (n < capacity) n++;
+    }
+    return n;
+}
@@ -0,0 +1,55 @@
+/**
+ * @file passing.h
+ * @brief Ranks the pass lanes from a ball carrier to each teammate.
+ * * A teammate is "open" when no opponent can reach the straight line of the
+ * pass before the ball gets there. For every lane the kernel finds, for each
+ * opponent, the closest point of the lane, how long the ball needs to get
+ * there, and how long the opponent needs to run within PLAYER_RADIUS of it.
+ * The smallest difference over all opponents is the lane's margin.
+ *
+ * It reads the per-tick snapshot from perception.h, so it only makes sense
+ * inside coach callbacks (or right after perception_update).
+ *
+ * Example (inside a shooting_logic function):
+ * @code
+ *   struct PassOption options[PLAYER_COUNT];
+ *   int n = passing_rank(scene, self, options, PLAYER_COUNT);
+ *   if (n > 0 && options[0].open) {
+ *       // kick towards options[0].receiver->position
+ *   }
+ * @endcode
+ */
+
+#ifndef ENGINE_GAME_PASSING_H
+#define ENGINE_GAME_PASSING_H
+
+#include <stdbool.h>
+
+struct Scene;
+struct Player;
+
+/**
+ * @struct PassOption
+ * @brief One teammate the ball carrier could pass to.
+ */
+struct PassOption {
+    struct Player* receiver;
+    float margin;   /**< Seconds between the ball passing and the quickest opponent arriving; < 0 means cut off. */
+    float arrival;  /**< Seconds for a full-power pass to reach the receiver; INFINITY if it stops short. */
+    float length;   /**< Distance to the receiver. */
+    bool open;      /**< The ball gets there and no opponent can reach the lane in time. */
+};
+
+/**
+ * @brief Scores every teammate of `carrier` and sorts them best first.
+ *
+ * Open lanes come first, then by margin (largest first). The ball is assumed
+ * to leave at the carrier's full shooting power and slow down with FRICTION.
+ *
+ * @param out Receives up to `capacity` options.
+ * @return Number of options written.
+ */
+int passing_rank(const struct Scene* scene, const struct Player* carrier,
+                 struct PassOption* out, int capacity);
+
+#endif
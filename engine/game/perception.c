@@ -0,0 +1,180 @@
+#include "perception.h"
+#include "scene.h"
+#include "entities/ball.h"
+#include "entities/player.h"
+
+#include <math.h>
+#include <string.h>
+
+#define FLOAT_ARRAYS 7     // x, y, max_speed, ball_distance, ball_bearing, goal_angle, goal_window
+#define INT_ARRAYS 2       // nearest_opponent, nearest_teammate
+
+// the int arrays are float-sized too
+static size_t array_bytes(int capacity) {
+    return arena_align_up((size_t)capacity * sizeof(float), PLAYER_BLOCK_ALIGN);
+}
+
+size_t perception_bytes(int team_size) {
+    return (FLOAT_ARRAYS + INT_ARRAYS) * array_bytes(PLAYER_BLOCK_CAPACITY(team_size)) + PLAYER_BLOCK_ALIGN
+         + 2 * spatial_grid_bytes(team_size);
+}
+
+static void* take(struct Arena* arena, int capacity) {
+    return arena_alloc(arena, array_bytes(capacity), PLAYER_BLOCK_ALIGN);
+}
+
+int perception_init(struct Perception* per, struct Arena* arena, int team_size) {
+    memset(per, 0, sizeof(*per));
+    const int capacity = PLAYER_BLOCK_CAPACITY(team_size);
+    per->capacity = capacity;
+    per->x = take(arena, capacity);
+    per->y = take(arena, capacity);
+    per->max_speed = take(arena, capacity);
+    per->ball_distance = take(arena, capacity);
+    per->ball_bearing = take(arena, capacity);
+    per->nearest_opponent = take(arena, capacity);
+    per->nearest_teammate = take(arena, capacity);
+    per->goal_angle = take(arena, capacity);
+    per->goal_window = take(arena, capacity);
+    if (!per->goal_window) return -1;
+    if (spatial_grid_init(&per->team_grid[0], arena, team_size) != 0) return -1;
+    return spatial_grid_init(&per->team_grid[1], arena, team_size);
+}
+
+/* Every pair; squared distances rank the same way, ties go to the lower slot. */
+static void nearest_by_scan(struct Perception* per, struct Player* const* view, int n) {
+    const int half = n / 2;
+    const float* x = per->x;
+    const float* y = per->y;
+    for (int i = 0; i < n; i++) {
+        int best_mate = -1, best_opp = -1;
+        float mate_d = INFINITY, opp_d = INFINITY;
+        if (view[i]) {
+            for (int j = 0; j < n; j++) {
+                if (j == i || !view[j]) continue;
+                const float dx = x[j] - x[i];
+                const float dy = y[j] - y[i];
+                const float d = dx * dx + dy * dy;
+                if ((j < half) == (i < half)) {
+                    if (d < mate_d) { mate_d = d; best_mate = j; }
+                } else {
+                    if (d < opp_d) { opp_d = d; best_opp = j; }
+                }
+            }
+        }
+        per->nearest_teammate[i] = best_mate;
+        per->nearest_opponent[i] = best_opp;
+    }
+}
+
+/*
+ * Same answers, looking only at the cells around each player. A query walks
+ * rings of cells until nothing closer can be left: about 8 cells for a mate,
+ * more for an opponent across the pitch. That bookkeeping makes a query cost
+ * as much as a few dozen pair checks whatever the team size, which is why
+ * small teams scan instead (GRID_NEAREST_MIN_SLOTS).
+ */
+static void nearest_by_grid(struct Perception* per, struct Player* const* view, int n) {
+    const int half = n / 2;
+    // one grid per team, so the far side of the pitch never gets scanned for mates
+    spatial_grid_build(&per->team_grid[0], per->x, per->y, view, 0, half);
+    spatial_grid_build(&per->team_grid[1], per->x, per->y, view, half, n);
+    for (int i = 0; i < n; i++) {
+        const struct SpatialGrid* own = &per->team_grid[i < half ? 0 : 1];
+        const struct SpatialGrid* other = &per->team_grid[i < half ? 1 : 0];
+        per->nearest_teammate[i] = view[i] ? spatial_grid_nearest(own, per->x, per->y, i) : -1;
+        per->nearest_opponent[i] = view[i] ? spatial_grid_nearest(other, per->x, per->y, i) : -1;
+    }
+}
+
+void perception_update(struct Scene* scene) {
+    struct Perception* per = &scene->perception;
+    const struct PlayerBlock* block = &scene->players;
+    const struct Ball* ball = scene->ball;
+    const int n = block->count;
+    const int half = n / 2;
+
+    // positions as plain arrays, so the loops below vectorize
+    float* x = per->x;
+    float* y = per->y;
+    for (int i = 0; i < per->capacity; i++) {
+        const struct Player* p = i < n ? block->view[i] : NULL;
+        x[i] = p ? p->position.x : 0.0f;
+        y[i] = p ? p->position.y : 0.0f;
+        per->max_speed[i] = p ? MAX_PLAYER_VELOCITY * p->talents.agility / MAX_TALENT_PER_SKILL : 0.0f;
+    }
+    per->count = n;
+
+    // ball and goal, per player
+    const float goal_top = (float)(CENTER_Y - GOAL_HEIGHT / 2);
+    const float goal_bottom = (float)(CENTER_Y + GOAL_HEIGHT / 2);
+    for (int i = 0; i < n; i++) {
+        const float bx = ball->position.x - x[i];
+        const float by = ball->position.y - y[i];
+        per->ball_distance[i] = sqrtf(bx * bx + by * by);
+        per->ball_bearing[i] = atan2f(by, bx);
+
+        // first team attacks the right goal, second team the left one
+        const float line = (i < half) ? (float)(PITCH_X + PITCH_W) : (float)PITCH_X;
+        const float gx = line - x[i];
+        per->goal_angle[i] = atan2f((float)CENTER_Y - y[i], gx);
+        // angle between the two post vectors: atan2(|cross|, dot)
+        const float ty = goal_top - y[i];
+        const float uy = goal_bottom - y[i];
+        per->goal_window[i] = fabsf(atan2f(gx * uy - ty * gx, gx * gx + ty * uy));
+    }
+
+    // nearest teammate / opponent; both ways pick the same slots
+    if (n >= GRID_NEAREST_MIN_SLOTS)
+        nearest_by_grid(per, block->view, n);
+    else
+        nearest_by_scan(per, block->view, n);
+}
+
+/* -------------------------------------------------------------------------
+ * Queries
+ * ------------------------------------------------------------------------- */
+static int slot_of(const struct Scene* scene, const struct Player* player) {
+    return player_block_slot(&scene->players, player);
+}
+
+float perception_distance(const struct Scene* scene, const struct Player* a, const struct Player* b) {
+    const int i = slot_of(scene, a), j = slot_of(scene, b);
+    if (i < 0 || j < 0) return INFINITY;
+    const struct Perception* per = &scene->perception;
+    const float dx = per->x[j] - per->x[i];
+    const float dy = per->y[j] - per->y[i];
+    return sqrtf(dx * dx + dy * dy);
+}
+
+float perception_ball_distance(const struct Scene* scene, const struct Player* player) {
+    const int i = slot_of(scene, player);
+    return i < 0 ? INFINITY : scene->perception.ball_distance[i];
+}
+
+float perception_ball_bearing(const struct Scene* scene, const struct Player* player) {
+    const int i = slot_of(scene, player);
+    return i < 0 ? 0.0f : scene->perception.ball_bearing[i];
+}
+
+struct Player* perception_nearest_opponent(const struct Scene* scene, const struct Player* player) {
+    const int i = slot_of(scene, player);
+    const int j = i < 0 ? -1 : scene->perception.nearest_opponent[i];
+    return j < 0 ? NULL : scene->players.view[j];
+}
+
+struct Player* perception_nearest_teammate(const struct Scene* scene, const struct Player* player) {
+    const int i = slot_of(scene, player);
+    const int j = i < 0 ? -1 : scene->perception.nearest_teammate[i];
+    return j < 0 ? NULL : scene->players.view[j];
+}
+
+float perception_goal_angle(const struct Scene* scene, const struct Player* player) {
+    const int i = slot_of(scene, player);
+    return i < 0 ? 0.0f : scene->perception.goal_angle[i];
+}
+
+float perception_goal_window(const struct Scene* scene, const struct Player* player) {
+    const int i = slot_of(scene, player);
+    return i < 0 ? 0.0f : scene->perception.goal_window[i];
+}
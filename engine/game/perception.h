@@ -0,0 +1,78 @@
+/**
+ * @file perception.h
+ * @brief What every player can "see", computed once per tick.
+ * * Coach callbacks tend to ask the same questions: how far is the ball, who
+ * is the nearest opponent, what is the angle to goal. Instead of every one of
+ * the players' 3 callbacks recomputing those from the raw Scene, the engine builds
+ * a snapshot right before the coaches run and the callbacks read from it.
+ *
+ * The snapshot describes positions at the start of the tick; it doesn't
+ * change while the coaches run, even though velocities and states do.
+ *
+ * Example (inside a change_state_logic function):
+ * @code
+ *   if (perception_ball_distance(scene, self) < 40.0f)
+ *       self->state = INTERCEPTING;
+ * @endcode
+ */
+
+#ifndef ENGINE_GAME_PERCEPTION_H
+#define ENGINE_GAME_PERCEPTION_H
+
+#include "game/player_block.h"
+#include "game/spatial_grid.h"
+
+struct Scene;
+struct Player;
+
+/**
+ * @struct Perception
+ * @brief Per-tick snapshot. Indexed by player slot (see player_block.h).
+ * Read it through the query functions below rather than directly.
+ */
+struct Perception {
+    int count;                  /**< Valid slots. */
+    int capacity;               /**< Length of every array (as in the PlayerBlock). */
+    float* x;                   /**< Position at the start of the tick. */
+    float* y;
+    float* max_speed;           /**< Top speed allowed by agility; 0 for empty slots. */
+    float* ball_distance;       /**< Centre-to-centre distance to the ball. */
+    float* ball_bearing;        /**< Direction to the ball, radians (like vec2Rotation). */
+    int* nearest_opponent;      /**< Slot, or -1 if there is none. */
+    int* nearest_teammate;      /**< Slot, or -1 if there is none. */
+    float* goal_angle;          /**< Direction to the centre of the goal being attacked. */
+    float* goal_window;         /**< Angle between that goal's posts, seen from the player. */
+    struct SpatialGrid team_grid[2]; /**< Each team's slots by cell, for big teams. */
+};
+
+/** @brief Arena bytes perception_init needs for this team size, padding included. */
+size_t perception_bytes(int team_size);
+
+/**
+ * @brief Carves the arrays for two teams of `team_size` out of `arena`.
+ * @return 0 on success, -1 if the arena is too small.
+ */
+int perception_init(struct Perception* per, struct Arena* arena, int team_size);
+
+/**
+ * @brief Rebuilds the snapshot from the scene. Called by the engine before
+ * the coaches run; coaches never need to call it.
+ */
+void perception_update(struct Scene* scene);
+
+/**
+ * @name Queries
+ * @brief All of these are O(1) lookups into the current snapshot.
+ * perception_distance works it out from the two stored positions.
+ */
+///@{
+float perception_distance(const struct Scene* scene, const struct Player* a, const struct Player* b);
+float perception_ball_distance(const struct Scene* scene, const struct Player* player);
+float perception_ball_bearing(const struct Scene* scene, const struct Player* player);
+struct Player* perception_nearest_opponent(const struct Scene* scene, const struct Player* player);
+struct Player* perception_nearest_teammate(const struct Scene* scene, const struct Player* player);
+float perception_goal_angle(const struct Scene* scene, const struct Player* player);
+float perception_goal_window(const struct Scene* scene, const struct Player* player);
+///@}
+
+#endif
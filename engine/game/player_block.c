@@ -0,0 +1,270 @@
+#include "player_block.h"
+#include "core/fixed.h"
+#include "entities/player.h"
+#include "entities/team.h"
+#include "game/spatial_grid.h"
+
+#include <math.h>
+#include <string.h>
+
+/*
+ * The kernels below loop over the whole (padded) capacity and avoid
+ * branches, so each one compiles to a handful of vector instructions.
+ * Unused slots are all zero and stay harmless.
+ */
+
+#define FLOAT_ARRAYS 5     // x, y, vx, vy, radius
+#define FIXED_ARRAYS 2     // push_x, push_y
+#define INT_ARRAYS 2       // intercepting, touching
+
+static size_t array_bytes(int capacity, size_t element) {
+    return arena_align_up((size_t)capacity * element, PLAYER_BLOCK_ALIGN);
+}
+
+size_t player_block_bytes(int team_size) {
+    const int capacity = PLAYER_BLOCK_CAPACITY(team_size);
+    return FLOAT_ARRAYS * array_bytes(capacity, sizeof(float))
+         + FIXED_ARRAYS * array_bytes(capacity, sizeof(fixed))
+         + INT_ARRAYS * array_bytes(capacity, sizeof(int))
+         + array_bytes(capacity, sizeof(struct Player*))
+         + PLAYER_BLOCK_ALIGN;  // the first array may need padding
+}
+
+static void* take(struct Arena* arena, int capacity, size_t element) {
+    return arena_alloc(arena, array_bytes(capacity, element), PLAYER_BLOCK_ALIGN);
+}
+
+int player_block_init(struct PlayerBlock* block, struct Arena* arena, int team_size) {
+    memset(block, 0, sizeof(*block));
+    block->team_size = team_size;
+    block->count = team_size * 2;
+    block->capacity = PLAYER_BLOCK_CAPACITY(team_size);
+    block->x = take(arena, block->capacity, sizeof(float));
+    block->y = take(arena, block->capacity, sizeof(float));
+    block->vx = take(arena, block->capacity, sizeof(float));
+    block->vy = take(arena, block->capacity, sizeof(float));
+    block->radius = take(arena, block->capacity, sizeof(float));
+    block->push_x = take(arena, block->capacity, sizeof(fixed));
+    block->push_y = take(arena, block->capacity, sizeof(fixed));
+    block->intercepting = take(arena, block->capacity, sizeof(int));
+    block->touching = take(arena, block->capacity, sizeof(int));
+    block->view = take(arena, block->capacity, sizeof(struct Player*));
+    return block->view ? 0 : -1;    // taken in order: if the last one fit, they all did
+}
+
+void player_block_bind(struct PlayerBlock* block, struct Team* first, struct Team* second) {
+    const size_t n = (size_t)block->capacity;
+    memset(block->x, 0, n * sizeof(float));
+    memset(block->y, 0, n * sizeof(float));
+    memset(block->vx, 0, n * sizeof(float));
+    memset(block->vy, 0, n * sizeof(float));
+    memset(block->radius, 0, n * sizeof(float));
+    memset(block->push_x, 0, n * sizeof(fixed));
+    memset(block->push_y, 0, n * sizeof(fixed));
+    memset(block->intercepting, 0, n * sizeof(int));
+    memset(block->touching, 0, n * sizeof(int));
+    memset(block->view, 0, n * sizeof(struct Player*));
+    for (int i = 0; i < block->team_size; i++) {
+        block->view[i] = first ? first->players[i] : NULL;
+        block->view[block->team_size + i] = second ? second->players[i] : NULL;
+    }
+}
+
+int player_block_slot(const struct PlayerBlock* block, const struct Player* player) {
+    if (!player || player->kit < 0 || player->kit >= block->team_size)
+        return -1;
+    const int slot = (player->team == 1 ? 0 : block->team_size) + player->kit;
+    return block->view[slot] == player ? slot : -1;
+}
+
+void player_block_gather(struct PlayerBlock* block) {
+    for (int i = 0; i < block->count; i++) {
+        const struct Player* p = block->view[i];
+        if (!p) continue;
+        block->x[i] = p->position.x;
+        block->y[i] = p->position.y;
+        block->vx[i] = p->velocity.x;
+        block->vy[i] = p->velocity.y;
+        block->radius[i] = p->radius;
+        block->intercepting[i] = (p->state == INTERCEPTING);
+    }
+}
+
+void player_block_scatter(const struct PlayerBlock* block) {
+    for (int i = 0; i < block->count; i++) {
+        struct Player* p = block->view[i];
+        if (!p) continue;
+        p->position.x = block->x[i];
+        p->position.y = block->y[i];
+    }
+}
+
+void player_block_integrate(struct PlayerBlock* block, float dt) {
+    float* restrict x = block->x;
+    float* restrict y = block->y;
+    const float* restrict vx = block->vx;
+    const float* restrict vy = block->vy;
+    const int n = block->capacity;
+
+#ifdef SOCCER_FIXED_POINT
+    const fixed step = fixed_from_float(dt);
+    for (int i = 0; i < n; i++) {
+        x[i] = fixed_to_float(fixed_from_float(x[i]) + fixed_mul(fixed_from_float(vx[i]), step));
+        y[i] = fixed_to_float(fixed_from_float(y[i]) + fixed_mul(fixed_from_float(vy[i]), step));
+    }
+#else
+    for (int i = 0; i < n; i++) {
+        x[i] += vx[i] * dt;
+        y[i] += vy[i] * dt;
+    }
+#endif
+}
+
+/* Pushes i and j apart along the line between them; i < j. */
+#ifdef SOCCER_FIXED_POINT
+static void push_pair(struct PlayerBlock* block, int i, int j) {
+    const fixed dx = fixed_from_float(block->x[j]) - fixed_from_float(block->x[i]);
+    const fixed dy = fixed_from_float(block->y[j]) - fixed_from_float(block->y[i]);
+    const fixed reach = fixed_from_float(block->radius[i]) + fixed_from_float(block->radius[j]);
+    const uint64_t d2 = fixed_length_sq(dx, dy);
+    if (d2 >= fixed_length_sq(reach, 0)) return;
+
+    // right on top of each other: the lower slot steps left
+    const fixed d = (fixed)fixed_isqrt64(d2);
+    const fixed nx = d > 0 ? fixed_div(dx, d) : FIXED_ONE;
+    const fixed ny = d > 0 ? fixed_div(dy, d) : 0;
+    const fixed half = (reach - d) / 2;
+    const fixed px = fixed_mul(nx, half);
+    const fixed py = fixed_mul(ny, half);
+    block->push_x[i] -= px;
+    block->push_y[i] -= py;
+    block->push_x[j] += px;
+    block->push_y[j] += py;
+}
+#else
+static void push_pair(struct PlayerBlock* block, int i, int j) {
+    const float dx = block->x[j] - block->x[i];
+    const float dy = block->y[j] - block->y[i];
+    const float reach = block->radius[i] + block->radius[j];
+    const float d2 = dx * dx + dy * dy;
+    if (d2 >= reach * reach) return;
+
+    // right on top of each other: the lower slot steps left
+    const float d = sqrtf(d2);
+    const float nx = d > 0.0f ? dx / d : 1.0f;
+    const float ny = d > 0.0f ? dy / d : 0.0f;
+    const float half = 0.5f * (reach - d);
+    const fixed px = fixed_from_float(nx * half);
+    const fixed py = fixed_from_float(ny * half);
+    block->push_x[i] -= px;
+    block->push_y[i] -= py;
+    block->push_x[j] += px;
+    block->push_y[j] += py;
+}
+#endif
+
+/* Every pair in a cell, and with the 4 neighbours after it (right, and the
+ * 3 below), so each pair of neighbouring cells is visited once. */
+static void separate_grid(struct PlayerBlock* block, const struct SpatialGrid* grid) {
+    static const int after[4][2] = {{1, 0}, {-1, 1}, {0, 1}, {1, 1}};
+    const int* start = grid->start;
+    const int* order = grid->order;
+
+    for (int cy = 0; cy < GRID_ROWS; cy++) {
+        for (int cx = 0; cx < GRID_COLUMNS; cx++) {
+            const int c = cy * GRID_COLUMNS + cx;
+            if (start[c] == start[c + 1]) continue;
+
+            for (int a = start[c]; a < start[c + 1]; a++)
+                for (int b = a + 1; b < start[c + 1]; b++)
+                    push_pair(block, order[a], order[b]);  // ascending within a cell
+
+            for (int k = 0; k < 4; k++) {
+                const int nx = cx + after[k][0], ny = cy + after[k][1];
+                if (nx < 0 || nx >= GRID_COLUMNS || ny >= GRID_ROWS) continue;
+                const int n = ny * GRID_COLUMNS + nx;
+                for (int a = start[c]; a < start[c + 1]; a++) {
+                    for (int b = start[n]; b < start[n + 1]; b++) {
+                        const int i = order[a], j = order[b];
+                        if (i < j) push_pair(block, i, j);
+                        else push_pair(block, j, i);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void player_block_separate(struct PlayerBlock* block, const struct SpatialGrid* grid) {
+    if (grid) {
+        separate_grid(block, grid);
+    } else {
+        struct Player* const* view = block->view;
+        for (int i = 0; i < block->count; i++) {
+            if (view && !view[i]) continue;
+            for (int j = i + 1; j < block->count; j++)
+                if (!view || view[j]) push_pair(block, i, j);
+        }
+    }
+
+    float* restrict x = block->x;
+    float* restrict y = block->y;
+    fixed* restrict px = block->push_x;
+    fixed* restrict py = block->push_y;
+    const int n = block->capacity;
+
+    for (int i = 0; i < n; i++) {
+#ifdef SOCCER_FIXED_POINT
+        x[i] = fixed_to_float(fixed_from_float(x[i]) + px[i]);
+        y[i] = fixed_to_float(fixed_from_float(y[i]) + py[i]);
+#else
+        x[i] += fixed_to_float(px[i]);
+        y[i] += fixed_to_float(py[i]);
+#endif
+        px[i] = 0;
+        py[i] = 0;
+    }
+}
+
+void player_block_clamp(struct PlayerBlock* block, float width, float height) {
+    float* restrict x = block->x;
+    float* restrict y = block->y;
+    const float* restrict r = block->radius;
+    const int n = block->capacity;
+
+    // same result as the old if-chains, written as min/max so it vectorizes
+    for (int i = 0; i < n; i++) {
+        const float max_x = width - r[i];
+        const float max_y = height - r[i];
+        float px = x[i] < r[i] ? r[i] : x[i];
+        float py = y[i] < r[i] ? r[i] : y[i];
+        x[i] = px > max_x ? max_x : px;
+        y[i] = py > max_y ? max_y : py;
+    }
+}
+
+void player_block_touching(const struct PlayerBlock* block, float cx, float cy, float cr,
+                           int* touching) {
+    const float* restrict x = block->x;
+    const float* restrict y = block->y;
+    const float* restrict r = block->radius;
+    const int* restrict intercepting = block->intercepting;
+    const int n = block->capacity;
+
+    // Circle-to-circle: dist^2 <= (r1 + r2)^2
+#ifdef SOCCER_FIXED_POINT
+    const fixed fx = fixed_from_float(cx), fy = fixed_from_float(cy), fr = fixed_from_float(cr);
+    for (int i = 0; i < n; i++) {
+        const fixed reach = fixed_from_float(r[i]) + fr;
+        const uint64_t d2 = fixed_length_sq(fixed_from_float(x[i]) - fx, fixed_from_float(y[i]) - fy);
+        touching[i] = (d2 <= fixed_length_sq(reach, 0)) & intercepting[i];
+    }
+#else
+    for (int i = 0; i < n; i++) {
+        const float dx = x[i] - cx;
+        const float dy = y[i] - cy;
+        const float reach = r[i] + cr;
+        touching[i] = (dx * dx + dy * dy <= reach * reach) & intercepting[i];
+    }
+#endif
+}
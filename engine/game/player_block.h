@@ -0,0 +1,104 @@
+/**
+ * @file player_block.h
+ * @brief Structure-of-arrays copy of every player's hot kinematic state.
+ * * Coaches and set-pieces keep working with `struct Player*` as before. Once
+ * per tick the scene gathers positions, velocities and states of both teams
+ * into contiguous arrays, runs the physics over them as straight-line loops
+ * the compiler can vectorize, and scatters the new positions back.
+ *
+ * Slot i < team_size is first_team->players[i]; slot team_size + i is
+ * second_team->players[i]. The arrays are sized for the scene's team size
+ * when it is created and live in the scene's arena.
+ */
+
+#ifndef ENGINE_GAME_PLAYER_BLOCK_H
+#define ENGINE_GAME_PLAYER_BLOCK_H
+
+#include "core/arena.h"
+#include "core/constants.h"
+#include "core/fixed.h"
+
+#include <stddef.h>
+
+struct Player;
+struct Team;
+struct SpatialGrid;
+
+/** Both teams, rounded up to a multiple of 8 floats (one AVX register). */
+#define PLAYER_BLOCK_CAPACITY(team_size) ((((team_size) * 2) + 7) & ~7)
+#define PLAYER_BLOCK_ALIGN 32   /**< Every array starts on an AVX boundary. */
+
+/**
+ * @struct PlayerBlock
+ * @brief Hot player state for one scene. Cold data (talents, AI) stays in Player.
+ */
+struct PlayerBlock {
+    int team_size;              /**< Players per team. */
+    int count;                  /**< Slots in use (2 * team_size). */
+    int capacity;               /**< Length of every array: count rounded up to 8. */
+    float* x;
+    float* y;
+    float* vx;
+    float* vy;
+    float* radius;
+    fixed* push_x;              /**< Scratch for player_block_separate, in fixed point; zero between calls. */
+    fixed* push_y;
+    int* intercepting;          /**< 1 if the player is in the INTERCEPTING state. */
+    int* touching;              /**< Scratch output for player_block_touching. */
+    struct Player** view;       /**< The Player each slot mirrors; NULL for an empty slot. */
+};
+
+/** @brief Arena bytes player_block_init needs for this team size, padding included. */
+size_t player_block_bytes(int team_size);
+
+/**
+ * @brief Carves the arrays for two teams of `team_size` out of `arena`.
+ * @return 0 on success, -1 if the arena is too small.
+ */
+int player_block_init(struct PlayerBlock* block, struct Arena* arena, int team_size);
+
+/**
+ * @brief Points the block's slots at the players of both teams.
+ * Must be called again whenever a team's player pointers change.
+ */
+void player_block_bind(struct PlayerBlock* block, struct Team* first, struct Team* second);
+
+/** @brief The slot a player occupies (from its team and kit), or -1. */
+int player_block_slot(const struct PlayerBlock* block, const struct Player* player);
+
+/** @brief Copies position, velocity and state from every Player into the arrays. */
+void player_block_gather(struct PlayerBlock* block);
+
+/** @brief Copies positions from the arrays back to every Player. */
+void player_block_scatter(const struct PlayerBlock* block);
+
+/** @brief position += velocity * dt for every slot. */
+void player_block_integrate(struct PlayerBlock* block, float dt);
+
+/**
+ * @brief Pushes overlapping players apart, each by half the overlap.
+ * * Every pair is resolved from the same starting positions. Each push is
+ * rounded to fixed point (core/fixed.h) and the pushes are added up as
+ * integers, which is exact: the result is bit for bit the same whatever
+ * order the pairs are found in, with or without the grid. Crowds can take a
+ * few ticks to spread out.
+ * A block whose `view` is NULL has every slot up to `count` occupied.
+ * @param grid Built from the block's current positions, or NULL to check
+ *             every pair (cheaper for small teams, see GRID_SEPARATE_MIN_SLOTS).
+ */
+void player_block_separate(struct PlayerBlock* block, const struct SpatialGrid* grid);
+
+/**
+ * @brief Keeps every player's whole body inside [0, width] x [0, height].
+ */
+void player_block_clamp(struct PlayerBlock* block, float width, float height);
+
+/**
+ * @brief Flags every intercepting player whose hitbox overlaps a circle.
+ * @param touching Receives 1 for each slot that overlaps and is intercepting, 0 otherwise
+ *                 (block->capacity entries; block->touching will do).
+ */
+void player_block_touching(const struct PlayerBlock* block, float cx, float cy, float cr,
+                           int* touching);
+
+#endif
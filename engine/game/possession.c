@@ -1,23 +1,10 @@
 #include "possession.h"
 #include "entities/team.h"
 
+#include <stdbool.h>
 #include <stdlib.h>
-#include <time.h>
 #include <stdio.h>
 
-/**
- * @brief Internal helper to check if a player's circular hitbox overlaps the ball's.
- * @return 1 if colliding, 0 otherwise.
- */
-static int is_colliding(const struct Player* p, const struct Ball* b) {
-    // Standard Circle-to-Circle collision math: (dist^2 <= combined_radius^2)
-    float dx = p->position.x - b->position.x;
-    float dy = p->position.y - b->position.y;
-    float dist_sq = dx * dx + dy * dy;
-    float radius_sum = p->radius + b->radius;
-    return dist_sq <= radius_sum * radius_sum;
-}
-
 /**
  * @brief Resolves a tackle attempt on the ball by a player.
  *
@@ -26,46 +13,67 @@ static int is_colliding(const struct Player* p, const struct Ball* b) {
  * the current possessor's dribbling skill and uses a weighted random roll
  * to determine if the tackle is successful.
  */
-void tackle(struct Player* player, struct Ball* ball) {
+void tackle(struct Scene* scene, struct Player* player) {
+    struct Ball* ball = scene->ball;
     if (!ball->possessor) {
         ball->possessor = player;
         ball->velocity.x = player->velocity.x;
         ball->velocity.y = player->velocity.y;
+        event_raise(&scene->events, (struct MatchEvent){
+            .type = EVENT_POSSESSION, .team = (uint8_t)player->team, .kit = (uint8_t)player->kit,
+            .x = ball->position.x, .y = ball->position.y});
         return;
     }
+    struct Player* holder = ball->possessor;
 
     int defence_score = player->talents.defence;
     int dribble_score = ball->possessor->talents.dribbling;
     int sum = defence_score + dribble_score;
 
-    srand((unsigned int)time(NULL));
-    int random_roll = rand() % sum;
+    int random_roll = (int)rng_below(&scene->rng, (uint32_t)sum);
 
-    if (random_roll < defence_score) {
+    const bool won = random_roll < defence_score;
+    if (won) {
         ball->possessor = player;
         ball->velocity.x = player->velocity.x;
         ball->velocity.y = player->velocity.y;
     }
+
+    if (holder == player)
+        return;     // already had it
+    struct MatchEvent event = {
+        .type = EVENT_TACKLE, .code = won, .team = (uint8_t)player->team, .kit = (uint8_t)player->kit,
+        .other_team = (uint8_t)holder->team, .other_kit = (uint8_t)holder->kit,
+        .x = ball->position.x, .y = ball->position.y,
+    };
+    event_raise(&scene->events, event);
+    if (won) {
+        event.type = EVENT_POSSESSION;
+        event_raise(&scene->events, event);
+    }
 }
 
 /**
  * @brief Updates which player currently possesses the ball.
  *
- * Iterates through all players on both teams and checks if any player
- * in the INTERCEPTING state is colliding with the ball.  
- * If so, calls `tackle()` to potentially transfer possession.
+ * Checks every player in the INTERCEPTING state against the ball in one
+ * pass over the scene's player block (see player_block_touching), then
+ * calls `tackle()` for each one touching it to potentially transfer
+ * possession. Tackles are resolved in the order red 0, blue 0, red 1, ...
  */
 void update_ball_possessor(struct Scene* scene) {
-    struct Ball* ball = scene->ball;
+    const struct Ball* ball = scene->ball;
+    const struct PlayerBlock* block = &scene->players;
 
-    for (int i = 0; i < PLAYER_COUNT; i++) {
-        struct Player* p1 = scene->first_team->players[i];
-        struct Player* p2 = scene->second_team->players[i];
+    const int n = block->team_size;
+    int* touching = block->touching;
+    player_block_touching(block, ball->position.x, ball->position.y, ball->radius, touching);
 
-        if (p1 && p1->state == INTERCEPTING && is_colliding(p1, ball))
-            tackle(p1, ball);
+    for (int i = 0; i < n; i++) {
+        if (touching[i])
+            tackle(scene, block->view[i]);
 
-        if (p2 && p2->state == INTERCEPTING && is_colliding(p2, ball))
-            tackle(p2, ball);
+        if (touching[n + i])
+            tackle(scene, block->view[n + i]);
     }
 }
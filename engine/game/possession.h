@@ -14,14 +14,17 @@
 
 /**
  * @brief Resolves a contest for the ball between a player and the current possessor.
- * * This uses a "Weighted Random" roll based on player talents. 
+ * * This uses a "Weighted Random" roll based on player talents, drawn from the
+ * scene's own random generator.
  * If (Player's Defence) > (Possessor's Dribbling), the ball likely changes hands.
  */
-void tackle(struct Player* player, struct Ball* ball);
+void tackle(struct Scene* scene, struct Player* player);
 
 /**
  * @brief Scans the field to see if any free player has touched the ball.
  * * Typically called every frame to bridge the gap between "Physics" and "Possession."
+ * Reads positions and states from `scene->players`, so gather the player
+ * block first (update_and_verify_scene_states does).
  */
 void update_ball_possessor(struct Scene* scene);
 
@@ -0,0 +1,65 @@
+#include "profiler.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static const char* phase_names[PROFILE_PHASE_COUNT] = {
+    "tick", "state", "perception", "think", "act", "possession", "physics", "referee", "render",
+};
+
+struct Profiler* profiler_create(void) {
+    return calloc(1, sizeof(struct Profiler));
+}
+
+void profiler_destroy(struct Profiler* profiler) {
+    free(profiler);
+}
+
+void profiler_reset(struct Profiler* profiler) {
+    memset(profiler, 0, sizeof(*profiler));
+}
+
+void profile_tick_done(struct Profiler* profiler) {
+    if (!profiler) return;
+    for (int i = 0; i < PROFILE_PHASE_COUNT; i++) {
+        if (profiler->touched & (1u << i)) {
+            histogram_record(&profiler->phase[i], profiler->pending[i]);
+            profiler->pending[i] = 0;
+        }
+    }
+    profiler->touched = 0;
+}
+
+void profile_record(struct Profiler* profiler, ProfilePhase phase, uint64_t ns) {
+    if (profiler)
+        histogram_record(&profiler->phase[phase], ns);
+}
+
+void profiler_stats(const struct Profiler* profiler, ProfilePhase phase, struct ProfileStats* out) {
+    const struct Histogram* h = &profiler->phase[phase];
+    out->count = h->count;
+    out->mean = histogram_mean(h);
+    out->p50 = histogram_percentile(h, 50.0);
+    out->p99 = histogram_percentile(h, 99.0);
+    out->max = h->max;
+}
+
+void profiler_merge(struct Profiler* into, const struct Profiler* from) {
+    for (int i = 0; i < PROFILE_PHASE_COUNT; i++)
+        histogram_merge(&into->phase[i], &from->phase[i]);
+}
+
+const char* profile_phase_name(ProfilePhase phase) {
+    return phase >= 0 && phase < PROFILE_PHASE_COUNT ? phase_names[phase] : "?";
+}
+
+void profiler_dump(const struct Profiler* profiler, FILE* out) {
+    fprintf(out, "%-11s %10s %10s %10s %10s %10s\n", "phase (us)", "count", "mean", "p50", "p99", "max");
+    for (int i = 0; i < PROFILE_PHASE_COUNT; i++) {
+        struct ProfileStats s;
+        profiler_stats(profiler, (ProfilePhase)i, &s);
+        if (s.count == 0) continue;
+        fprintf(out, "%-11s %10llu %10.2f %10.2f %10.2f %10.2f\n", phase_names[i],
+                (unsigned long long)s.count, s.mean / 1e3, s.p50 / 1e3, s.p99 / 1e3, s.max / 1e3);
+    }
+}
@@ -0,0 +1,102 @@
+/**
+ * @file profiler.h
+ * @brief Per-phase tick timings, kept as latency histograms.
+ * * A Scene with a Profiler attached (scene->profiler) times every phase of
+ * every tick: match flow, the coaches' THINK and ACT passes, possession,
+ * physics and the referee, plus the tick as a whole. Phases that run more
+ * than once a tick (once per team) are summed, so every histogram holds
+ * one value per tick. The viewer adds the time spent drawing each frame.
+ *
+ * With no profiler attached (the default) each timer is a NULL check.
+ *
+ * A profiler belongs to the thread running its scene: query it from there,
+ * or after the match. Profilers of several matches can be merged.
+ *
+ * Example:
+ * @code
+ *   scene->profiler = profiler_create();
+ *   ... play ...
+ *   struct ProfileStats think;
+ *   profiler_stats(scene->profiler, PROFILE_THINK, &think);   // think.p99 etc.
+ *   profiler_dump(scene->profiler, stdout);
+ * @endcode
+ */
+
+#ifndef ENGINE_GAME_PROFILER_H
+#define ENGINE_GAME_PROFILER_H
+
+#include "core/clock.h"
+#include "core/histogram.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * @enum ProfilePhase
+ */
+typedef enum {
+    PROFILE_TICK,       /**< The whole of update_scene. */
+    PROFILE_STATE,      /**< Match flow: clock, set-pieces, kick-off shots. */
+    PROFILE_PERCEPTION, /**< Building the coaches' perception snapshot. */
+    PROFILE_THINK,      /**< change_state_logic of both teams. */
+    PROFILE_ACT,        /**< movement_logic / shooting_logic of both teams. */
+    PROFILE_POSSESSION, /**< update_ball_possessor. */
+    PROFILE_PHYSICS,    /**< Moving players and ball. */
+    PROFILE_REFEREE,    /**< referee() and its consequences. */
+    PROFILE_RENDER,     /**< renderer_draw_scene, one value per frame. */
+    PROFILE_PHASE_COUNT
+} ProfilePhase;
+
+/**
+ * @struct Profiler
+ * @brief One histogram per phase, in nanoseconds.
+ */
+struct Profiler {
+    uint64_t pending[PROFILE_PHASE_COUNT];  /**< This tick's time so far. */
+    unsigned int touched;                   /**< Phases that ran this tick (bit per phase). */
+    struct Histogram phase[PROFILE_PHASE_COUNT];
+};
+
+/**
+ * @struct ProfileStats
+ * @brief Summary of one phase, in nanoseconds.
+ */
+struct ProfileStats {
+    uint64_t count;
+    double mean;
+    uint64_t p50;
+    uint64_t p99;
+    uint64_t max;
+};
+
+/** @return NULL if out of memory. */
+struct Profiler* profiler_create(void);
+void profiler_destroy(struct Profiler* profiler);
+void profiler_reset(struct Profiler* profiler);
+
+/** @brief Starts a timer. Costs nothing but the check if `profiler` is NULL. */
+static inline uint64_t profile_begin(const struct Profiler* profiler) {
+    return profiler ? clock_now_ns() : 0;
+}
+
+/** @brief Adds the time since profile_begin to this tick's `phase`. */
+static inline void profile_end(struct Profiler* profiler, ProfilePhase phase, uint64_t start) {
+    if (!profiler) return;
+    profiler->pending[phase] += clock_now_ns() - start;
+    profiler->touched |= 1u << phase;
+}
+
+/** @brief Ends the tick: every phase that ran gets one value. */
+void profile_tick_done(struct Profiler* profiler);
+
+/** @brief Records one value directly (for things that aren't part of a tick, like drawing). */
+void profile_record(struct Profiler* profiler, ProfilePhase phase, uint64_t ns);
+
+void profiler_stats(const struct Profiler* profiler, ProfilePhase phase, struct ProfileStats* out);
+void profiler_merge(struct Profiler* into, const struct Profiler* from);
+const char* profile_phase_name(ProfilePhase phase);
+
+/** @brief Writes a table (count, mean, p50, p99, max per phase, in microseconds). */
+void profiler_dump(const struct Profiler* profiler, FILE* out);
+
+#endif
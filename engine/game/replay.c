@@ -0,0 +1,552 @@
+#include "replay.h"
+#include "scene.h"
+#include "core/segment_writer.h"
+#include "entities/ball.h"
+#include "entities/player.h"
+#include "entities/team.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define WRITER_BUFFER_SIZE (256 * 1024)
+#define DEFAULT_SEGMENT_BYTES (8u * 1024 * 1024)
+
+/* -------------------------------------------------------------------------
+ * Frames
+ * ------------------------------------------------------------------------- */
+static int32_t quantize(float v) {
+    return (int32_t)lrintf(v * REPLAY_SCALE);
+}
+
+static void capture_entity(int32_t* f, struct Vec2 position, struct Vec2 velocity, int state) {
+    f[REPLAY_X] = quantize(position.x);
+    f[REPLAY_Y] = quantize(position.y);
+    f[REPLAY_VX] = quantize(velocity.x);
+    f[REPLAY_VY] = quantize(velocity.y);
+    f[REPLAY_STATE] = state;
+}
+
+void replay_capture(struct ReplayFrame* frame, const struct Scene* scene, uint32_t tick) {
+    const struct Ball* ball = scene->ball;
+    const struct PlayerBlock* block = &scene->players;
+    int32_t* f = frame->field;
+
+    frame->tick = tick;
+    frame->field_count = REPLAY_MATCH_FIELDS + REPLAY_ENTITY_FIELDS * (1 + block->count);
+
+    f[REPLAY_GAME_STATE] = (int32_t)scene->state;
+    f[REPLAY_FIRST_SCORE] = (int32_t)scene->first_team->score;
+    f[REPLAY_SECOND_SCORE] = (int32_t)scene->second_team->score;
+    f[REPLAY_REMAINING_CS] = (int32_t)lrintf(scene->remaining_time * 100.0f);
+    f[REPLAY_POSSESSOR] = player_block_slot(block, ball->possessor) + 1;
+    f[REPLAY_LAST_TEAM] = ball->last_team;
+
+    capture_entity(&f[REPLAY_FIELD(0, 0)], ball->position, ball->velocity, 0);
+    for (int i = 0; i < block->count; i++) {
+        const struct Player* p = block->view[i];
+        int32_t* e = &f[REPLAY_FIELD(1 + i, 0)];
+        if (p)
+            capture_entity(e, p->position, p->velocity, (int)p->state);
+        else
+            memset(e, 0, sizeof(int32_t) * REPLAY_ENTITY_FIELDS);
+    }
+}
+
+/* Frames are sized for the largest teams; copy only the fields in use. */
+static void copy_frame(struct ReplayFrame* to, const struct ReplayFrame* from) {
+    to->tick = from->tick;
+    to->field_count = from->field_count;
+    memcpy(to->field, from->field, sizeof(int32_t) * (size_t)from->field_count);
+}
+
+static struct Vec2 dequantize(const int32_t* f) {
+    return (struct Vec2){(float)f[0] / REPLAY_SCALE, (float)f[1] / REPLAY_SCALE};
+}
+
+void replay_apply(struct Scene* scene, const struct ReplayFrame* frame, const struct ReplayFrame* prev) {
+    const int32_t* f = frame->field;
+    const int32_t* p = prev ? prev->field : f;
+    const struct PlayerBlock* block = &scene->players;
+    struct Ball* ball = scene->ball;
+
+    scene->state = (GameState)f[REPLAY_GAME_STATE];
+    scene->first_team->score = (unsigned)f[REPLAY_FIRST_SCORE];
+    scene->second_team->score = (unsigned)f[REPLAY_SECOND_SCORE];
+    scene->remaining_time = f[REPLAY_REMAINING_CS] / 100.0f;
+    ball->last_team = f[REPLAY_LAST_TEAM];
+    const int possessor = f[REPLAY_POSSESSOR] - 1;
+    ball->possessor = (possessor >= 0 && possessor < block->count) ? block->view[possessor] : NULL;
+
+    ball->position = dequantize(&f[REPLAY_FIELD(0, REPLAY_X)]);
+    ball->velocity = dequantize(&f[REPLAY_FIELD(0, REPLAY_VX)]);
+    ball->prev_position = dequantize(&p[REPLAY_FIELD(0, REPLAY_X)]);
+
+    const int entities = (frame->field_count - REPLAY_MATCH_FIELDS) / REPLAY_ENTITY_FIELDS;
+    for (int i = 0; i < block->count && 1 + i < entities; i++) {
+        struct Player* player = block->view[i];
+        if (!player) continue;
+        player->position = dequantize(&f[REPLAY_FIELD(1 + i, REPLAY_X)]);
+        player->velocity = dequantize(&f[REPLAY_FIELD(1 + i, REPLAY_VX)]);
+        player->prev_position = dequantize(&p[REPLAY_FIELD(1 + i, REPLAY_X)]);
+        player->state = (PlayerActionState)f[REPLAY_FIELD(1 + i, REPLAY_STATE)];
+    }
+}
+
+/* -------------------------------------------------------------------------
+ * Byte-level encoding
+ * ------------------------------------------------------------------------- */
+static uint8_t* put_u16(uint8_t* out, uint32_t v) {
+    out[0] = (uint8_t)v;
+    out[1] = (uint8_t)(v >> 8);
+    return out + 2;
+}
+
+static uint8_t* put_u32(uint8_t* out, uint32_t v) {
+    for (int i = 0; i < 4; i++) out[i] = (uint8_t)(v >> (8 * i));
+    return out + 4;
+}
+
+static uint8_t* put_u64(uint8_t* out, uint64_t v) {
+    for (int i = 0; i < 8; i++) out[i] = (uint8_t)(v >> (8 * i));
+    return out + 8;
+}
+
+static uint32_t get_u16(const uint8_t* in) {
+    return (uint32_t)in[0] | ((uint32_t)in[1] << 8);
+}
+
+static uint32_t get_u32(const uint8_t* in) {
+    uint32_t v = 0;
+    for (int i = 0; i < 4; i++) v |= (uint32_t)in[i] << (8 * i);
+    return v;
+}
+
+static uint64_t get_u64(const uint8_t* in) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++) v |= (uint64_t)in[i] << (8 * i);
+    return v;
+}
+
+/* small magnitudes of either sign become small unsigned numbers: 0, -1, 1, -2 ... -> 0, 1, 2, 3 ... */
+static uint32_t zigzag(int32_t v) {
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static int32_t unzigzag(uint32_t v) {
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+/* 7 bits per byte, high bit set on every byte but the last */
+static uint8_t* put_varint(uint8_t* out, uint32_t v) {
+    while (v >= 0x80) {
+        *out++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *out++ = (uint8_t)v;
+    return out;
+}
+
+static const uint8_t* get_varint(const uint8_t* in, const uint8_t* end, uint32_t* v) {
+    uint32_t result = 0;
+    for (int shift = 0; shift < 35 && in < end; shift += 7) {
+        const uint8_t byte = *in++;
+        result |= (uint32_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            *v = result;
+            return in;
+        }
+    }
+    return NULL;
+}
+
+size_t replay_write_header(uint8_t* out, const struct ReplayHeader* header) {
+    uint8_t* p = out;
+    memcpy(p, "SRPL", 4);
+    p = put_u16(p + 4, header->version);
+    p = put_u16(p, header->scale);
+    p = put_u32(p, header->tick_rate);
+    p = put_u64(p, header->seed);
+    p = put_u32(p, header->entity_count);
+    p = put_u32(p, header->first_tick);
+    return (size_t)(p - out);
+}
+
+bool replay_read_header(const uint8_t* in, size_t len, struct ReplayHeader* header) {
+    if (len < REPLAY_HEADER_SIZE || memcmp(in, "SRPL", 4) != 0)
+        return false;
+    header->version = get_u16(in + 4);
+    header->scale = get_u16(in + 6);
+    header->tick_rate = get_u32(in + 8);
+    header->seed = get_u64(in + 12);
+    header->entity_count = get_u32(in + 20);
+    header->first_tick = get_u32(in + 24);
+    return header->version == REPLAY_VERSION && header->entity_count >= 1 &&
+           header->entity_count <= REPLAY_MAX_ENTITIES;
+}
+
+size_t replay_encode_frame(uint8_t* out, const struct ReplayFrame* frame, const struct ReplayFrame* prev) {
+    const int n = frame->field_count;
+    uint8_t* p = out;
+
+    if (!prev) {
+        *p++ = 'K';
+        p = put_varint(p, frame->tick);
+        for (int i = 0; i < n; i++)
+            p = put_varint(p, zigzag(frame->field[i]));
+        return (size_t)(p - out);
+    }
+
+    *p++ = 'D';
+    p = put_varint(p, frame->tick - prev->tick);
+    uint8_t* bitmap = p;
+    p += (n + 7) / 8;
+    memset(bitmap, 0, (size_t)(n + 7) / 8);
+    for (int i = 0; i < n; i++) {
+        const int32_t delta = (int32_t)((uint32_t)frame->field[i] - (uint32_t)prev->field[i]);
+        if (delta == 0) continue;
+        bitmap[i / 8] |= (uint8_t)(1u << (i % 8));
+        p = put_varint(p, zigzag(delta));
+    }
+    return (size_t)(p - out);
+}
+
+size_t replay_decode_frame(const uint8_t* in, size_t len, struct ReplayFrame* frame) {
+    const uint8_t* p = in;
+    const uint8_t* end = in + len;
+    const int n = frame->field_count;
+    uint32_t v;
+
+    if (p >= end) return 0;
+    const uint8_t kind = *p++;
+    if (kind == 'K') {
+        if (!(p = get_varint(p, end, &v))) return 0;
+        frame->tick = v;
+        for (int i = 0; i < n; i++) {
+            if (!(p = get_varint(p, end, &v))) return 0;
+            frame->field[i] = unzigzag(v);
+        }
+    } else if (kind == 'D') {
+        if (!(p = get_varint(p, end, &v))) return 0;
+        frame->tick += v;
+        const uint8_t* bitmap = p;
+        p += (n + 7) / 8;
+        if (p > end) return 0;
+        for (int i = 0; i < n; i++) {
+            if (!(bitmap[i / 8] & (1u << (i % 8)))) continue;
+            if (!(p = get_varint(p, end, &v))) return 0;
+            frame->field[i] = (int32_t)((uint32_t)frame->field[i] + (uint32_t)unzigzag(v));
+        }
+    } else {
+        return 0;
+    }
+    return (size_t)(p - in);
+}
+
+/* -------------------------------------------------------------------------
+ * Recorder
+ * ------------------------------------------------------------------------- */
+struct ReplayRecorder {
+    struct SegmentWriter* writer;
+    struct ReplayConfig config;
+    uint64_t seed;
+    int tick_rate;
+
+    struct ReplayFrame prev;        /**< Last frame written, base for the next delta. */
+    struct ReplayFrame frame;
+    bool have_prev;
+    bool new_segment;               /**< Next frame starts a file: header + keyframe. */
+    size_t segment_size;            /**< Bytes written to the current file so far. */
+    uint32_t last_keyframe;
+    unsigned long dropped;
+
+    int index_count;                /**< Keyframes in the current file so far. */
+    uint32_t index_tick[REPLAY_MAX_INDEX];
+    uint32_t index_offset[REPLAY_MAX_INDEX];
+};
+
+struct ReplayRecorder* replay_recorder_create(const struct ReplayConfig* config, uint64_t seed,
+                                              int tick_rate) {
+    struct ReplayRecorder* r = calloc(1, sizeof(*r));
+    if (!r) return NULL;
+
+    r->config = *config;
+    if (r->config.segment_bytes == 0) r->config.segment_bytes = DEFAULT_SEGMENT_BYTES;
+    if (r->config.keyframe_interval <= 0) r->config.keyframe_interval = tick_rate > 0 ? tick_rate : SIM_TICK_RATE;
+    r->seed = seed;
+    r->tick_rate = tick_rate;
+    r->new_segment = true;
+
+    r->writer = segment_writer_create(config->prefix, ".rpl", config->max_segments, WRITER_BUFFER_SIZE);
+    if (!r->writer) {
+        free(r);
+        return NULL;
+    }
+    return r;
+}
+
+/* Bytes of the keyframe index at the end of a file with `keyframes` entries. */
+static size_t footer_bytes(int keyframes) {
+    return 8 * (size_t)keyframes + 8;
+}
+
+/*
+ * Appends the keyframe index and closes the file, without waiting for the
+ * writer: every frame reservation leaves room for the footer after it, so
+ * the footer always fits in the front buffer. Returns false (try again
+ * next tick) only if that buffer already ends SEGMENT_WRITER_MAX_CUTS files
+ * and the writer is too busy to take it.
+ */
+static bool finish_segment(struct ReplayRecorder* r) {
+    if (!segment_writer_can_end_segment(r->writer) && !segment_writer_flush(r->writer))
+        return false;
+    const size_t len = footer_bytes(r->index_count);
+    uint8_t* out = segment_writer_reserve(r->writer, len);
+    if (!out)
+        return false;
+
+    uint8_t* p = out;
+    for (int i = 0; i < r->index_count; i++) {
+        p = put_u32(p, r->index_tick[i]);
+        p = put_u32(p, r->index_offset[i]);
+    }
+    p = put_u32(p, (uint32_t)r->index_count);
+    memcpy(p, "SRPI", 4);
+    segment_writer_commit(r->writer, len);
+    segment_writer_end_segment(r->writer);
+
+    r->new_segment = true;
+    r->segment_size = 0;
+    r->index_count = 0;
+    return true;
+}
+
+void replay_record(struct ReplayRecorder* r, const struct Scene* scene, uint32_t tick) {
+    // move on to the next file once this one is big enough
+    if (!r->new_segment &&
+        (r->segment_size >= r->config.segment_bytes || r->index_count == REPLAY_MAX_INDEX))
+        finish_segment(r);
+
+    replay_capture(&r->frame, scene, tick);
+    const bool keyframe = r->new_segment || !r->have_prev ||
+                          tick - r->last_keyframe >= (uint32_t)r->config.keyframe_interval;
+
+    // room for this file's footer too, with this frame's index entry
+    const int keyframes = r->new_segment ? 1 : r->index_count + (keyframe ? 1 : 0);
+    uint8_t* out = segment_writer_reserve(r->writer, REPLAY_HEADER_SIZE + REPLAY_MAX_FRAME_BYTES +
+                                                     footer_bytes(keyframes));
+    if (!out) {
+        // the disk is behind: skip this tick, and make the next frame stand on its own
+        r->dropped++;
+        r->have_prev = false;
+        return;
+    }
+
+    size_t len = 0;
+    if (r->new_segment) {
+        const struct ReplayHeader header = {
+            .version = REPLAY_VERSION,
+            .scale = REPLAY_SCALE,
+            .tick_rate = (uint32_t)r->tick_rate,
+            .seed = r->seed,
+            .entity_count = (uint32_t)((r->frame.field_count - REPLAY_MATCH_FIELDS) / REPLAY_ENTITY_FIELDS),
+            .first_tick = tick,
+        };
+        len = replay_write_header(out, &header);
+        r->new_segment = false;
+    }
+    if (keyframe && r->index_count < REPLAY_MAX_INDEX) {
+        r->index_tick[r->index_count] = tick;
+        r->index_offset[r->index_count] = (uint32_t)(r->segment_size + len);
+        r->index_count++;
+    }
+    len += replay_encode_frame(out + len, &r->frame, keyframe ? NULL : &r->prev);
+    segment_writer_commit(r->writer, len);
+    r->segment_size += len;
+
+    if (keyframe) r->last_keyframe = tick;
+    copy_frame(&r->prev, &r->frame);
+    r->have_prev = true;
+
+    // hand full-enough buffers over early so the writer stays busy in small pieces
+    if (segment_writer_pending(r->writer) >= WRITER_BUFFER_SIZE / 2)
+        segment_writer_flush(r->writer);
+}
+
+unsigned long replay_recorder_dropped(const struct ReplayRecorder* r) {
+    return r->dropped;
+}
+
+void replay_recorder_destroy(struct ReplayRecorder* r) {
+    if (!r) return;
+    if (!r->new_segment) {
+        segment_writer_wait(r->writer);
+        finish_segment(r);
+    }
+    segment_writer_destroy(r->writer);
+    free(r);
+}
+
+/* -------------------------------------------------------------------------
+ * Reader
+ * ------------------------------------------------------------------------- */
+static uint32_t key_tick(const struct ReplayFile* f, int i) {
+    return get_u32(f->index + 8 * (size_t)i);
+}
+
+static uint32_t key_offset(const struct ReplayFile* f, int i) {
+    return get_u32(f->index + 8 * (size_t)i + 4);
+}
+
+/* Decodes the frame at `offset` over `frame`; returns the offset after it, 0 on failure. */
+static size_t decode_at(const struct ReplayFile* f, size_t offset, struct ReplayFrame* frame) {
+    if (offset >= f->frames_end) return 0;
+    const size_t used = replay_decode_frame(f->file.data + offset, f->frames_end - offset, frame);
+    return used ? offset + used : 0;
+}
+
+/* No footer: walk the frames once and note every keyframe. */
+static bool rebuild_index(struct ReplayFile* f) {
+    size_t capacity = 64;
+    int count = 0;
+    uint8_t* index = malloc(8 * capacity);
+    if (!index) return false;
+
+    struct ReplayFrame frame = {.field_count = f->frame.field_count};
+    size_t offset = REPLAY_HEADER_SIZE;
+    for (;;) {
+        const bool key = offset < f->frames_end && f->file.data[offset] == 'K';
+        const size_t next = decode_at(f, offset, &frame);
+        if (!next) break;
+        if (key) {
+            if ((size_t)count == capacity) {
+                uint8_t* grown = realloc(index, 8 * capacity * 2);
+                if (!grown) break;
+                index = grown;
+                capacity *= 2;
+            }
+            put_u32(put_u32(index + 8 * (size_t)count, frame.tick), (uint32_t)offset);
+            count++;
+        }
+        offset = next;
+    }
+    f->frames_end = offset;     // drop a half-written last frame
+    f->rebuilt_index = index;
+    f->index = index;
+    f->keyframes = count;
+    return true;
+}
+
+bool replay_open(struct ReplayFile* f, const char* path) {
+    memset(f, 0, sizeof(*f));
+    if (!mapped_file_open(&f->file, path))
+        return false;
+    const uint8_t* data = f->file.data;
+    const size_t size = f->file.size;
+    if (!replay_read_header(data, size, &f->header)) {
+        mapped_file_close(&f->file);
+        return false;
+    }
+    f->frame.field_count = REPLAY_MATCH_FIELDS + REPLAY_ENTITY_FIELDS * (int)f->header.entity_count;
+
+    // the footer, if the file was finished properly
+    f->frames_end = size;
+    if (size >= REPLAY_HEADER_SIZE + 8 && memcmp(data + size - 4, "SRPI", 4) == 0) {
+        const uint32_t count = get_u32(data + size - 8);
+        const size_t footer = 8 * (size_t)count + 8;
+        if (count > 0 && footer <= size - REPLAY_HEADER_SIZE) {
+            f->frames_end = size - footer;
+            f->index = data + f->frames_end;
+            f->keyframes = (int)count;
+        }
+    }
+    if (!f->index && !rebuild_index(f)) {
+        replay_close(f);
+        return false;
+    }
+    if (f->keyframes == 0) {
+        replay_close(f);
+        return false;
+    }
+
+    // find the last tick from the last keyframe
+    replay_seek(f, UINT32_MAX);
+    f->last_tick = f->frame.tick;
+    return replay_seek(f, 0);
+}
+
+void replay_close(struct ReplayFile* f) {
+    free(f->rebuilt_index);
+    mapped_file_close(&f->file);
+    memset(f, 0, sizeof(*f));
+}
+
+bool replay_next(struct ReplayFile* f) {
+    struct ReplayFrame next;
+    copy_frame(&next, &f->frame);
+    const size_t after = decode_at(f, f->next, &next);
+    if (!after) return false;
+    copy_frame(&f->frame, &next);
+    f->next = after;
+    return true;
+}
+
+bool replay_seek(struct ReplayFile* f, uint32_t tick) {
+    // last keyframe at or before tick
+    int lo = 0, hi = f->keyframes - 1;
+    while (lo < hi) {
+        const int mid = lo + (hi - lo + 1) / 2;
+        if (key_tick(f, mid) <= tick) lo = mid;
+        else hi = mid - 1;
+    }
+    const size_t after = decode_at(f, key_offset(f, lo), &f->frame);
+    if (!after) return false;
+    f->next = after;
+
+    // then deltas up to tick
+    while (f->frame.tick < tick) {
+        struct ReplayFrame next;
+        copy_frame(&next, &f->frame);
+        const size_t end = decode_at(f, f->next, &next);
+        if (!end || next.tick > tick) break;
+        copy_frame(&f->frame, &next);
+        f->next = end;
+    }
+    return true;
+}
+
+static int32_t goals_in(const struct ReplayFrame* frame) {
+    return frame->field[REPLAY_FIRST_SCORE] + frame->field[REPLAY_SECOND_SCORE];
+}
+
+int replay_find_goals(const struct ReplayFile* f, uint32_t* ticks, int capacity) {
+    struct ReplayFrame frame = {.field_count = f->frame.field_count};
+    int found = 0;
+    int32_t goals = 0;
+    bool scanned = false;
+    uint32_t scanned_to = 0;    // last tick already looked at
+
+    // keyframes tell us which intervals have a goal; only those get decoded
+    for (int k = 0; k < f->keyframes; k++) {
+        if (!decode_at(f, key_offset(f, k), &frame)) break;
+        if (k > 0 && goals_in(&frame) == goals) continue;
+
+        const size_t stop = k + 1 < f->keyframes ? key_offset(f, k + 1) : f->frames_end;
+        size_t offset = decode_at(f, key_offset(f, k > 0 ? k - 1 : 0), &frame);
+        int32_t before = goals_in(&frame);
+        while (offset && offset < stop) {
+            offset = decode_at(f, offset, &frame);
+            if (!offset) break;
+            const bool seen = scanned && frame.tick <= scanned_to;
+            if (!seen && goals_in(&frame) > before) {
+                if (found < capacity) ticks[found] = frame.tick;
+                found++;
+            }
+            before = goals_in(&frame);
+        }
+        scanned = true;
+        scanned_to = frame.tick;
+        goals = before;
+    }
+    return found;
+}
@@ -0,0 +1,189 @@
+/**
+ * @file replay.h
+ * @brief Compact per-tick match recordings.
+ * * Every tick becomes a frame of small integers: match state, scores, clock,
+ * and the quantized position, velocity and state of the ball and every
+ * player (1/REPLAY_SCALE px and px/s). Most frames only store what changed
+ * since the previous one, as zigzag varints behind a "changed" bitmap; a
+ * keyframe with every value in full is written every keyframe_interval ticks
+ * and at the start of every file.
+ *
+ * File layout (all integers little-endian):
+ * @code
+ *   header   "SRPL", version, scale, tick rate, seed, entity count, first tick
+ *   frame*   'K' tick field*              (keyframe, absolute values)
+ *            'D' dtick bitmap field*      (delta from the previous frame)
+ *   footer   (u32 tick, u32 offset)* u32 count "SRPI"   (one entry per keyframe)
+ * @endcode
+ *
+ * The footer lets a reader jump to any tick by decoding one keyframe and at
+ * most keyframe_interval deltas after it. A file that was cut short (the
+ * program died mid-match) has no footer; the reader then rebuilds the index
+ * with one pass over the frames.
+ *
+ * Recording goes through a background writer (core/segment_writer.h), so
+ * the simulation never waits on the disk; if the disk can't keep up, frames
+ * are dropped and the next one is a keyframe.
+ */
+
+#ifndef ENGINE_GAME_REPLAY_H
+#define ENGINE_GAME_REPLAY_H
+
+#include "core/mapped_file.h"
+#include "game/player_block.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+struct Scene;
+
+#define REPLAY_VERSION 1
+#define REPLAY_SCALE 8          /**< Quantization steps per pixel. */
+#define REPLAY_HEADER_SIZE 28
+#define REPLAY_MAX_INDEX 4096   /**< Keyframes per file; a new file is started after this many. */
+
+/**
+ * @name Frame layout
+ * @brief A frame is a flat array of int32 fields: the match fields first,
+ * then REPLAY_ENTITY_FIELDS per entity. Entity 0 is the ball, entity 1 + s
+ * is the player in slot s (see player_block.h).
+ */
+///@{
+enum {
+    REPLAY_GAME_STATE,
+    REPLAY_FIRST_SCORE,
+    REPLAY_SECOND_SCORE,
+    REPLAY_REMAINING_CS,        /**< Remaining match time, centiseconds. */
+    REPLAY_POSSESSOR,           /**< Slot + 1 of the ball possessor, 0 for none. */
+    REPLAY_LAST_TEAM,
+    REPLAY_MATCH_FIELDS
+};
+enum { REPLAY_X, REPLAY_Y, REPLAY_VX, REPLAY_VY, REPLAY_STATE, REPLAY_ENTITY_FIELDS };
+
+#define REPLAY_MAX_ENTITIES (1 + 2 * MAX_TEAM_SIZE)
+#define REPLAY_MAX_FIELDS (REPLAY_MATCH_FIELDS + REPLAY_ENTITY_FIELDS * REPLAY_MAX_ENTITIES)
+#define REPLAY_FIELD(entity, field) (REPLAY_MATCH_FIELDS + (entity) * REPLAY_ENTITY_FIELDS + (field))
+///@}
+
+/** @brief Worst-case size of one encoded frame. */
+#define REPLAY_MAX_FRAME_BYTES (1 + 5 + (REPLAY_MAX_FIELDS + 7) / 8 + 5 * REPLAY_MAX_FIELDS)
+
+/**
+ * @struct ReplayHeader
+ * @brief Start of every replay file.
+ */
+struct ReplayHeader {
+    uint32_t version;
+    uint32_t scale;
+    uint32_t tick_rate;
+    uint64_t seed;
+    uint32_t entity_count;
+    uint32_t first_tick;
+};
+
+/**
+ * @struct ReplayFrame
+ * @brief One decoded tick.
+ */
+struct ReplayFrame {
+    uint32_t tick;
+    int field_count;
+    int32_t field[REPLAY_MAX_FIELDS];
+};
+
+/** @brief Quantizes the scene into a frame. */
+void replay_capture(struct ReplayFrame* frame, const struct Scene* scene, uint32_t tick);
+
+/**
+ * @brief The opposite of replay_capture: puts a recorded tick back into a
+ * scene (created with the same seed) so it can be drawn.
+ * * `prev` (may be NULL) becomes everyone's prev_position, for interpolation.
+ */
+void replay_apply(struct Scene* scene, const struct ReplayFrame* frame, const struct ReplayFrame* prev);
+
+size_t replay_write_header(uint8_t* out, const struct ReplayHeader* header);
+/** @return false if `in` doesn't start with a replay header this build can read. */
+bool replay_read_header(const uint8_t* in, size_t len, struct ReplayHeader* header);
+
+/**
+ * @brief Encodes `frame`, as a delta from `prev` or as a keyframe if `prev` is NULL.
+ * @param out At least REPLAY_MAX_FRAME_BYTES.
+ * @return Bytes written.
+ */
+size_t replay_encode_frame(uint8_t* out, const struct ReplayFrame* frame, const struct ReplayFrame* prev);
+
+/**
+ * @brief Decodes one frame in place: `frame` must hold the previous frame
+ * (for deltas) and have field_count set from the header.
+ * @return Bytes consumed, or 0 if the data is truncated or corrupt.
+ */
+size_t replay_decode_frame(const uint8_t* in, size_t len, struct ReplayFrame* frame);
+
+/**
+ * @struct ReplayConfig
+ * @brief Where and how to record. Zero values pick the defaults.
+ */
+struct ReplayConfig {
+    const char* prefix;         /**< Files are "<prefix>-000000.rpl", "<prefix>-000001.rpl", ... */
+    size_t segment_bytes;       /**< Start a new file on the first tick this much has been written (default 8 MB). */
+    int max_segments;           /**< Delete older files beyond this many (0 keeps all). */
+    int keyframe_interval;      /**< Ticks between keyframes (default: one per second). */
+};
+
+struct ReplayRecorder;
+
+/** @return NULL if the writer couldn't be started. */
+struct ReplayRecorder* replay_recorder_create(const struct ReplayConfig* config, uint64_t seed,
+                                              int tick_rate);
+
+/** @brief Records the scene as it is after tick number `tick`. Never blocks. */
+void replay_record(struct ReplayRecorder* recorder, const struct Scene* scene, uint32_t tick);
+
+/** @brief Frames dropped so far because the disk couldn't keep up. */
+unsigned long replay_recorder_dropped(const struct ReplayRecorder* recorder);
+
+/** @brief Writes out what's left and closes the last file. */
+void replay_recorder_destroy(struct ReplayRecorder* recorder);
+
+/**
+ * @struct ReplayFile
+ * @brief A replay file opened for reading, with a cursor on one frame.
+ */
+struct ReplayFile {
+    struct MappedFile file;
+    struct ReplayHeader header;
+    size_t frames_end;          /**< Where the frames stop (the footer starts). */
+    const uint8_t* index;       /**< Keyframe (tick, offset) pairs, as stored in the footer. */
+    uint8_t* rebuilt_index;     /**< Owned copy when the file had no footer. */
+    int keyframes;
+    uint32_t last_tick;
+
+    struct ReplayFrame frame;   /**< The frame under the cursor. */
+    size_t next;                /**< Offset of the frame after it. */
+};
+
+/**
+ * @brief Maps a replay file and positions the cursor on its first frame.
+ * @return false if it isn't a readable replay.
+ */
+bool replay_open(struct ReplayFile* replay, const char* path);
+void replay_close(struct ReplayFile* replay);
+
+/** @brief Moves the cursor to the next frame. @return false at the end. */
+bool replay_next(struct ReplayFile* replay);
+
+/**
+ * @brief Moves the cursor to the last frame at or before `tick` (or the first
+ * frame, if `tick` is earlier). Costs one keyframe plus at most one
+ * keyframe interval of deltas, wherever `tick` is.
+ */
+bool replay_seek(struct ReplayFile* replay, uint32_t tick);
+
+/**
+ * @brief Ticks on which a goal was scored, earliest first. Leaves the cursor alone.
+ * @return Number of goals found (up to `capacity` are written).
+ */
+int replay_find_goals(const struct ReplayFile* replay, uint32_t* ticks, int capacity);
+
+#endif
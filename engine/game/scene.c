@@ -1,78 +1,243 @@
 #include "scene.h"
+#include "core/fixed.h"
+#include "core/log.h"
 #include "game/possession.h"
 #include "entities/ball.h"
 #include "entities/team.h"
 #include "logic/coach.h"
+#include "logic/referee.h"
 
 #include <math.h>
-#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <stdbool.h>
 
+/**
+ * Bytes one scene needs: the Scene itself, the physics, perception and grid
+ * arrays, the ball, two teams and every player.
+ */
+static size_t scene_block_size(int team_size) {
+    const size_t a = ARENA_DEFAULT_ALIGN;
+    return arena_align_up(sizeof(struct Scene), a)
+         + player_block_bytes(team_size)
+         + perception_bytes(team_size)
+         + spatial_grid_bytes(PLAYER_BLOCK_CAPACITY(team_size))
+         + arena_align_up(sizeof(struct Ball), a)
+         + 2 * arena_align_up(sizeof(struct Team), a)
+         + 2 * arena_align_up(team_size * sizeof(struct Player*), a)
+         + 2 * (size_t)team_size * arena_align_up(sizeof(struct Player), a)
+         + a;   // slack in case malloc's alignment is weaker than ours
+}
+
+Scene* scene_create(int team_size, uint64_t seed, uint32_t events) {
+    if (team_size <= 0) team_size = PLAYER_COUNT;
+    if (team_size > MAX_TEAM_SIZE) {
+        LOG_ERROR(LOG_SCENE, "a team can have at most %d players, not %d", MAX_TEAM_SIZE, team_size);
+        return NULL;
+    }
+    const size_t size = scene_block_size(team_size);
+    void* block = malloc(size);
+    if (!block) return NULL;
+
+    struct Arena arena;
+    arena_init(&arena, block, size);
+    Scene* scene = arena_alloc(&arena, sizeof(struct Scene), ARENA_DEFAULT_ALIGN);
+
+    // memcpy, because assignment can't write the const field dimensions
+    Scene temp = { .field = {SCREEN_WIDTH, SCREEN_HEIGHT}, .team_size = team_size };
+    memcpy(scene, &temp, sizeof(struct Scene));
+    // sized once for the team size, so they stay put across resets
+    player_block_init(&scene->players, &arena, team_size);
+    perception_init(&scene->perception, &arena, team_size);
+    spatial_grid_init(&scene->grid, &arena, scene->players.capacity);
+    scene->arena = arena;
+    scene->arena_mark = arena.used;
+    events_init(&scene->events);
+    events_subscribe(&scene->events, events);
+
+    scene_reset(scene, seed);
+    return scene;
+}
+
 /**
  * @brief Initializes the game scene, including teams, players, and the ball.
  * @param scene Pointer to the Scene to initialize.
+ * @param seed Seed for the scene's random generator; same seed, same match.
  */
-void init_scene(struct Scene *scene) {
+void scene_reset(struct Scene *scene, uint64_t seed) {
+    struct Arena* arena = &scene->arena;
+    arena_reset(arena, scene->arena_mark);
+    events_bind(scene);     // verify_talents reports to this scene
+    scene->events.tick = 0;
+    scene->events.dropped = 0;
+
+    scene->seed = seed;
+    rng_seed(&scene->rng, seed);
     scene->remaining_time = 120.0f; // 2 minutes game
     scene->wait_time = 0.0f;
-    scene->first_team = make_team_ptr();
-    scene->second_team = make_team_ptr();
+    scene->tick_dt = 1.0f / SIM_TICK_RATE;
 
-    // create players
-    for (int i = 0; i < PLAYER_COUNT; i++) {
-        scene->first_team->players[i] = make_player_ptr((float)(50 + i * 50), 300, 1, i);
-        scene->second_team->players[i] = make_player_ptr((float)(700 - i * 40), 300, 2, i);
+    scene->ball = make_ball_at(arena_alloc(arena, sizeof(struct Ball), ARENA_DEFAULT_ALIGN), 0, 0);
+    scene->first_team = arena_alloc(arena, sizeof(struct Team), ARENA_DEFAULT_ALIGN);
+    scene->second_team = arena_alloc(arena, sizeof(struct Team), ARENA_DEFAULT_ALIGN);
+    *scene->first_team = make_team();
+    *scene->second_team = make_team();
+    const int n = scene->team_size;
+    struct Team* teams[2] = {scene->first_team, scene->second_team};
+    for (int t = 0; t < 2; t++) {
+        teams[t]->size = n;
+        teams[t]->players = arena_alloc(arena, n * sizeof(struct Player*), ARENA_DEFAULT_ALIGN);
     }
 
+    // create players; set_piece_goal below puts them in formation
+    for (int i = 0; i < n; i++) {
+        void* p1 = arena_alloc(arena, sizeof(struct Player), ARENA_DEFAULT_ALIGN);
+        void* p2 = arena_alloc(arena, sizeof(struct Player), ARENA_DEFAULT_ALIGN);
+        scene->first_team->players[i] = make_player_at(p1, (float)(50 + i * 50), 300, 1, i);
+        scene->second_team->players[i] = make_player_at(p2, (float)(700 - i * 40), 300, 2, i);
+    }
+    player_block_bind(&scene->players, scene->first_team, scene->second_team);
+
     // initialize ball
-    scene->ball->position.x = CENTER_X + (rand() % 2) * 2 - 1;  // gives -1 or +1, randomly selecting starter team
+    scene->ball->position.x = CENTER_X + (int)rng_below(&scene->rng, 2) * 2 - 1;  // gives -1 or +1, randomly selecting starter team
     scene->ball->position.y = CENTER_Y;
     set_piece_goal(scene);
     scene->state = STATE_RESTARTING;
 }
 
+void scene_destroy(Scene* scene) {
+    // the Scene lives at the start of its own block
+    if (scene) free(scene->arena.base);
+}
+
+static uint64_t hash_bytes(uint64_t hash, const void* data, size_t size) {
+    const unsigned char* p = data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= p[i];
+        hash *= 1099511628211ull;   // FNV prime
+    }
+    return hash;
+}
+
+static uint64_t hash_vec2(uint64_t hash, struct Vec2 v) {
+    // bit patterns, fixed byte order: the same on any platform
+    uint32_t bits[2];
+    memcpy(&bits[0], &v.x, sizeof(float));
+    memcpy(&bits[1], &v.y, sizeof(float));
+    for (int k = 0; k < 2; k++) {
+        const unsigned char b[4] = {(unsigned char)bits[k], (unsigned char)(bits[k] >> 8),
+                                    (unsigned char)(bits[k] >> 16), (unsigned char)(bits[k] >> 24)};
+        hash = hash_bytes(hash, b, sizeof(b));
+    }
+    return hash;
+}
+
+static uint64_t hash_int(uint64_t hash, int32_t v) {
+    const uint32_t u = (uint32_t)v;
+    const unsigned char b[4] = {(unsigned char)u, (unsigned char)(u >> 8),
+                                (unsigned char)(u >> 16), (unsigned char)(u >> 24)};
+    return hash_bytes(hash, b, sizeof(b));
+}
+
+uint64_t scene_hash(const Scene* scene, uint64_t hash) {
+    hash = hash_int(hash, (int32_t)scene->first_team->score);
+    hash = hash_int(hash, (int32_t)scene->second_team->score);
+    hash = hash_int(hash, scene->state);
+    hash = hash_vec2(hash, scene->ball->position);
+    hash = hash_vec2(hash, scene->ball->velocity);
+    const struct Team* teams[2] = {scene->first_team, scene->second_team};
+    for (int t = 0; t < 2; t++) {
+        for (int i = 0; i < scene->team_size; i++) {
+            const struct Player* p = teams[t]->players[i];
+            hash = hash_vec2(hash, p->position);
+            hash = hash_vec2(hash, p->velocity);
+            hash = hash_int(hash, p->state);
+        }
+    }
+    return hash;
+}
+
+/**
+ * @brief Builds this tick's perception snapshot, then lets both teams think and act.
+ */
+void scene_run_coaches(struct Scene *scene) {
+    const uint64_t start = profile_begin(scene->profiler);
+    perception_update(scene);
+    profile_end(scene->profiler, PROFILE_PERCEPTION, start);
+    update_team(scene, scene->first_team);
+    update_team(scene, scene->second_team);
+}
+
+float ball_friction_per_tick(float dt) {
+#ifdef SOCCER_FIXED_POINT
+    const fixed exponent = fixed_mul(fixed_from_float(dt), fixed_from_float(FRICTION_REFERENCE_RATE));
+    return fixed_to_float(fixed_pow(fixed_from_float(FRICTION), exponent));
+#else
+    return powf(FRICTION, dt * FRICTION_REFERENCE_RATE);
+#endif
+}
+
+/* ball_friction_per_tick, worked out once per tick length */
+static float ball_friction(Scene* scene, float dt) {
+    if (scene->friction_dt != dt) {
+        scene->friction_dt = dt;
+        scene->friction = ball_friction_per_tick(dt);
+    }
+    return scene->friction;
+}
+
 /**
  * @brief Updates the states of both teams in the scene.
  * @param scene Pointer to the Scene to update.
  */
 void update_and_verify_scene_states(struct Scene *scene, const float dt) {
-    update_team(scene, scene->first_team);
-    update_team(scene, scene->second_team);
+    scene_run_coaches(scene);
+
+    // physics runs on the contiguous copy of both teams
+    struct PlayerBlock* block = &scene->players;
+    uint64_t start = profile_begin(scene->profiler);
+    player_block_gather(block);
     update_ball_possessor(scene);
-    
-    for (int i = 0; i < PLAYER_COUNT; i++) {
-        struct Player* p1 = scene->first_team->players[i];
-        struct Player* p2 = scene->second_team->players[i];
+    profile_end(scene->profiler, PROFILE_POSSESSION, start);
 
-        // move players
-        p1->position.x += p1->velocity.x * dt;
-        p1->position.y += p1->velocity.y * dt;
-        p2->position.x += p2->velocity.x * dt;
-        p2->position.y += p2->velocity.y * dt;
-        // make sure no one walks off the pitch
-        if (p1->position.x < p1->radius) p1->position.x = p1->radius;
-        if (p1->position.x > SCREEN_WIDTH - p1->radius) p1->position.x = SCREEN_WIDTH - p1->radius;
-        if (p1->position.y < p1->radius) p1->position.y = p1->radius;
-        if (p1->position.y > SCREEN_HEIGHT - p1->radius) p1->position.y = SCREEN_HEIGHT - p1->radius;
-        if (p2->position.x < p2->radius) p2->position.x = p2->radius;
-        if (p2->position.x > SCREEN_WIDTH - p2->radius) p2->position.x = SCREEN_WIDTH - p2->radius;
-        if (p2->position.y < p2->radius) p2->position.y = p2->radius;
-        if (p2->position.y > SCREEN_HEIGHT - p2->radius) p2->position.y = SCREEN_HEIGHT - p2->radius;
-    }
+    // move players, keep them from walking through each other or off the pitch
+    start = profile_begin(scene->profiler);
+    player_block_integrate(block, dt);
+    const bool use_grid = block->count >= GRID_SEPARATE_MIN_SLOTS;
+    if (use_grid)
+        spatial_grid_build(&scene->grid, block->x, block->y, block->view, 0, block->count);
+    player_block_separate(block, use_grid ? &scene->grid : NULL);
+    player_block_clamp(block, SCREEN_WIDTH, SCREEN_HEIGHT);
+    player_block_scatter(block);
 
     struct Ball* ball = scene->ball;
     if (ball->possessor != NULL)
         ball->last_team = ball->possessor->team;
+    const struct Vec2 from = ball->position;
+#ifdef SOCCER_FIXED_POINT
+    // same steps as below, in integers
+    const fixed step = fixed_from_float(dt);
+    const struct FixedVec2 velocity = fvec2_from(ball->velocity);
+    ball->position = fvec2_to(fvec2_add(fvec2_from(ball->position), fvec2_scale(velocity, step)));
+    scene->ball_sweep = sweep_ball(from, ball->position, ball->radius);
+    const struct FixedVec2 slowed = fvec2_scale(velocity, fixed_from_float(ball_friction(scene, dt)));
+    const fixed stop = fixed_from_float(10.0f);
+    ball->velocity = fixed_length_sq(slowed.x, slowed.y) < fixed_length_sq(stop, 0)
+                   ? (struct Vec2){0, 0} : fvec2_to(slowed);
+#else
     ball->position.x += ball->velocity.x * dt;
     ball->position.y += ball->velocity.y * dt;
-    ball->velocity.x *= FRICTION;
-    ball->velocity.y *= FRICTION;
+    // before the bounce below moves it: what did the ball fly over?
+    scene->ball_sweep = sweep_ball(from, ball->position, ball->radius);
+    const float friction = ball_friction(scene, dt);
+    ball->velocity.x *= friction;
+    ball->velocity.y *= friction;
     // finally the ball stops
     if (hypotf(ball->velocity.x, ball->velocity.y) < 10.0f) {
         ball->velocity.x = 0;
         ball->velocity.y = 0;
     }
+#endif
     // ball bounces off the window edges 
     if (ball->position.x - ball->radius < 0) {
         ball->position.x = ball->radius;
@@ -90,6 +255,23 @@ void update_and_verify_scene_states(struct Scene *scene, const float dt) {
         ball->position.y = SCREEN_HEIGHT - ball->radius;
         ball->velocity.y = -ball->velocity.y;
     }
+    profile_end(scene->profiler, PROFILE_PHYSICS, start);
+}
+
+/**
+ * @brief Remembers where everything is before a tick moves it.
+ * * The renderer draws between `prev_position` and `position`. Set-pieces call
+ * this after teleporting players so the jump isn't drawn as a slide.
+ */
+void scene_store_previous_positions(struct Scene* scene) {
+    scene->ball->prev_position = scene->ball->position;
+
+    for (int i = 0; i < scene->team_size; i++) {
+        struct Player* p1 = scene->first_team->players[i];
+        struct Player* p2 = scene->second_team->players[i];
+        if (p1) p1->prev_position = p1->position;
+        if (p2) p2->prev_position = p2->position;
+    }
 }
 
 /**
@@ -101,7 +283,7 @@ void stop_movements(struct Scene* scene) {
     scene->ball->velocity.y = 0.0f;
 
     // Stop all players from both teams
-    for (int i = 0; i < PLAYER_COUNT; i++) {
+    for (int i = 0; i < scene->team_size; i++) {
         if (scene->first_team->players[i]) {
             scene->first_team->players[i]->velocity.x = 0.0f;
             scene->first_team->players[i]->velocity.y = 0.0f;
@@ -113,6 +295,20 @@ void stop_movements(struct Scene* scene) {
     }
 }
 
+/* Is p closer to `point` than `than` (true if there's no `than` yet)? */
+static bool closer_to(const struct Player* p, const struct Player* than, struct Vec2 point) {
+    if (!than) return true;
+#ifdef SOCCER_FIXED_POINT
+    const struct FixedVec2 to = fvec2_from(point);
+    const struct FixedVec2 a = fvec2_sub(fvec2_from(p->position), to);
+    const struct FixedVec2 b = fvec2_sub(fvec2_from(than->position), to);
+    return fixed_length_sq(a.x, a.y) < fixed_length_sq(b.x, b.y);
+#else
+    return hypotf(p->position.x - point.x, p->position.y - point.y)
+         < hypotf(than->position.x - point.x, than->position.y - point.y);
+#endif
+}
+
 /**
  * @brief Places ball and players after out or corner.
  */
@@ -122,8 +318,7 @@ void set_piece_out(struct Scene* scene) {
 
     struct Ball* ball = scene->ball;
     if (ball->last_team == 0) {
-        printf("it's not clear which team throw the ball out!\n");
-        printf("let's assume it was the first team.\n");
+        LOG_WARN(LOG_SCENE, "it's not clear which team throw the ball out! let's assume it was the first team.");
         ball->last_team = 1;
     }
     int last_team = ball->last_team;
@@ -170,32 +365,32 @@ void set_piece_out(struct Scene* scene) {
     }
 
     // Find the closest player to the ball to take the throw-in/kick-in
+    struct Team* taker = (last_team == 2) ? scene->first_team : scene->second_team;
     struct Player* kicker = NULL;
-    float min_dist = 999999.0f;
-    struct Player* p = NULL;
-    if (last_team == 2) {
-        for(int i=0; i < PLAYER_COUNT; i++) {
-            p = scene->first_team->players[i];
-            float d = hypotf(p->position.x - ball->position.x, p->position.y - ball->position.y);
-            if (d < min_dist) { min_dist = d; kicker = p; }
-        }
-    } else {
-        for(int i=0; i < PLAYER_COUNT; i++) {
-            p = scene->second_team->players[i];
-            float d = hypotf(p->position.x - ball->position.x, p->position.y - ball->position.y);
-            if (d < min_dist) { min_dist = d; kicker = p; }
-        }
+    for (int i = 0; i < scene->team_size; i++) {
+        struct Player* p = taker->players[i];
+        if (p && closer_to(p, kicker, ball->position)) kicker = p;
     }
 
     if (!kicker) {
-        printf("couln't select a player throw-in the ball!\n");
+        LOG_WARN(LOG_SCENE, "couln't select a player throw-in the ball!");
         return;
     }
     ball->possessor = kicker;
     ball->last_team = kicker->team;
     // Position the player slightly "behind" the ball relative to the pitch center
-    float dir_x = (CENTER_X) - ball->position.x;
-    float dir_y = (CENTER_Y) - ball->position.y;
+    const struct Vec2 centre = {CENTER_X, CENTER_Y};
+#ifdef SOCCER_FIXED_POINT
+    const struct FixedVec2 at = fvec2_from(ball->position);
+    const struct FixedVec2 dir = fvec2_sub(fvec2_from(centre), at);
+    const fixed length = fvec2_length(dir);
+    const struct FixedVec2 unit = length > 0 ? (struct FixedVec2){fixed_div(dir.x, length), fixed_div(dir.y, length)}
+                                             : (struct FixedVec2){FIXED_ONE, 0};
+    kicker->position = fvec2_to(fvec2_sub(at, fvec2_scale(unit, fixed_from_float(15.0f))));
+    ball->position = fvec2_to(fvec2_add(at, fvec2_scale(unit, fixed_from_float(5.0f))));
+#else
+    float dir_x = centre.x - ball->position.x;
+    float dir_y = centre.y - ball->position.y;
     float length = hypotf(dir_x, dir_y);
     
     // Normalize and push player 30 units away from center, behind the ball
@@ -204,10 +399,36 @@ void set_piece_out(struct Scene* scene) {
 
     ball->position.x += (dir_x / length) * 5.0f;
     ball->position.y += (dir_y / length) * 5.0f;
+#endif
 
+    scene_store_previous_positions(scene);
     return;
 }
 
+/**
+ * @brief Where a player lines up for a kick-off.
+ * The coach picks the spots for the default team size. Any other size gets
+ * a grid of lines spread over the team's own half, at least `keep_out`
+ * from the centre spot.
+ */
+static Vec2 kickoff_position(const struct Scene* scene, const struct Player* p, float keep_out) {
+    const int n = scene->team_size;
+    if (n == PLAYER_COUNT)
+        return get_positions(p->team, p->kit);
+
+    const int lines = (int)ceilf(sqrtf((float)n));
+    const int per_line = (n + lines - 1) / lines;
+    const float depth = (float)CENTER_X - keep_out - PITCH_X - PLAYER_RADIUS;  // goal line to keep_out
+    const float line = (float)(p->kit / per_line) + 0.5f;
+    const float slot = (float)(p->kit % per_line) + 0.5f;
+    const float from_goal = PLAYER_RADIUS + depth * line / (float)lines;
+    Vec2 position = {
+        .x = p->team == 1 ? PITCH_X + from_goal : PITCH_X + PITCH_W - from_goal,
+        .y = PITCH_Y + PITCH_H * slot / (float)per_line,
+    };
+    return position;
+}
+
 /**
  * @brief Resets ball and players to kickoff positions after a goal.
  */
@@ -228,7 +449,7 @@ void set_piece_goal(struct Scene* scene) {
     const float padding = 20.0f; // Extra space to ensure they are outside the line
 
     // Position Kickoff Team
-    for (int i = 0; i < PLAYER_COUNT; i++) {
+    for (int i = 0; i < scene->team_size; i++) {
         struct Player* p = kickoff_team->players[i];
         if (!p) continue;
 
@@ -242,21 +463,139 @@ void set_piece_goal(struct Scene* scene) {
             ball->last_team = p->team;
         } else {
             // Others stay on their half, outside the center circle
-            Vec2 position = get_positions(p->team, p->kit);
+            Vec2 position = kickoff_position(scene, p, circle_radius + padding);
             p->position.x = position.x;
             p->position.y = position.y;
         }
     }
 
     // Position Waiting Team
-    for (int i = 0; i < PLAYER_COUNT; i++) {
+    for (int i = 0; i < scene->team_size; i++) {
         struct Player* p = waiting_team->players[i];
         if (!p) continue;
 
-        Vec2 position = get_positions(p->team, p->kit);
+        Vec2 position = kickoff_position(scene, p, circle_radius + padding);
         p->position.x = position.x;
         p->position.y = position.y;
     }
 
-    printf("Team %d is about to kick-off\n", (kickoff_team == scene->first_team ? 1 : 2));
+    scene_store_previous_positions(scene);
+    event_raise(&scene->events, (struct MatchEvent){
+        .type = EVENT_KICKOFF, .team = (kickoff_team == scene->first_team ? 1 : 2)});
+}
+
+/**
+ * @brief Phase 1 of a tick: match flow (restart delays, set-pieces, the clock).
+ * @return true if the match is running and the physics should be stepped.
+ */
+bool scene_advance_clock(Scene* scene, const float dt) {
+    scene->tick_dt = dt;
+    scene->events.tick++;
+    events_bind(scene);
+
+    // --- State: RESTARTING (The short Delay before calling player to kick-off) ---
+    if (scene->state == STATE_RESTARTING) {
+        scene->wait_time -= dt;
+        if (scene->wait_time <= 0) {
+            scene->state = STATE_RUNNING;
+            struct Ball* ball = scene->ball;
+            struct Player* player = ball->possessor;
+            event_raise(&scene->events, (struct MatchEvent){
+                .type = EVENT_RESTART, .team = (uint8_t)player->team, .kit = (uint8_t)player->kit});
+            perception_update(scene);
+            player->shooting_logic(player, scene);
+            verify_shoot(ball, true);
+            scene->ball->possessor = NULL;
+        }
+        return false; // Don't process physics yet
+    }
+
+    // --- State: OUT ---
+    if (scene->state == STATE_OUT) {
+        scene->wait_time -= dt;
+        if (scene->wait_time < 0) {
+            scene->wait_time = 2.0f;    // wait 2 more seconds before calling the player to throw in
+            set_piece_out(scene);       // Position players/ball
+            scene->state = STATE_RESTARTING;
+        }
+        return false;
+    }
+
+    // --- State: GOAL ---
+    if (scene->state == STATE_GOAL) {
+        scene->wait_time -= dt;
+        if (scene->wait_time < 0) {
+            scene->wait_time = 2.0f;    // wait 2 more seconds before calling the player to kick off
+            set_piece_goal(scene);      // Position players/ball
+            scene->state = STATE_RESTARTING;
+        }
+        return false;
+    }
+
+    if (scene->state != STATE_RUNNING) return false; // scene->state == STATE_TIMEOUT
+    scene->remaining_time -= dt;
+    // --- State: TIMEOUT ---
+    if (scene->remaining_time < 0.0f) {
+        event_raise(&scene->events, (struct MatchEvent){.type = EVENT_FULL_TIME});
+        scene->state = STATE_TIMEOUT;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Phase 3 of a tick: react to the referee's decision.
+ * Scores are the referee's business; this only changes the match flow.
+ */
+void scene_apply_referee(Scene* scene, int code) {
+    switch (code) {
+        case GOAL:
+            scene->state = STATE_GOAL;
+            scene->wait_time = 5.0f; // 5 second delay before kick-off
+            event_raise(&scene->events, (struct MatchEvent){
+                .type = EVENT_GOAL, .team = (uint8_t)scene->ball->last_team,
+                .value = {scene->first_team->score, scene->second_team->score}});
+            break;
+        case OUT:
+            scene->state = STATE_OUT;
+            scene->wait_time = 2.0f; // 2 second delay before set-piece
+            event_raise(&scene->events, (struct MatchEvent){
+                .type = EVENT_OUT, .team = (uint8_t)scene->ball->last_team,
+                .x = scene->ball->position.x, .y = scene->ball->position.y});
+            break;
+        default:
+            break;  // no event, game continues
+    }
+}
+
+/**
+ * @brief Main logic dispatcher.
+ * * This function orchestrates the three phases of a tick:
+ * 1. Time Management (Is the game over?)
+ * 2. Scene Update (Physics & Movement)
+ * 3. Referee Check (Rules & Fouls)
+ */
+void update_scene(Scene* scene, const float dt) {
+    struct Profiler* profiler = scene->profiler;
+    const uint64_t tick_start = profile_begin(profiler);
+    scene_store_previous_positions(scene);
+
+    // ----------------------------- PHASE 1: state controll -----------------------------
+    uint64_t start = profile_begin(profiler);
+    const bool running = scene_advance_clock(scene, dt);
+    profile_end(profiler, PROFILE_STATE, start);
+
+    if (running) {
+        // ----------------------------- PHASE 2: update the scene -----------------------------
+        update_and_verify_scene_states(scene, dt);
+
+        // ----------------------------- PHASE 3: call the referee -----------------------------
+        // after screen update, call the referee to check all the rules
+        start = profile_begin(profiler);
+        scene_apply_referee(scene, referee(scene));
+        profile_end(profiler, PROFILE_REFEREE, start);
+    }
+
+    profile_end(profiler, PROFILE_TICK, tick_start);
+    profile_tick_done(profiler);
 }
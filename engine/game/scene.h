@@ -9,6 +9,16 @@
 #define ENGINE_GRAPHICS_SCENE_H
 
 #include "entities/field.h"
+#include "core/arena.h"
+#include "core/rng.h"
+#include "game/events.h"
+#include "game/player_block.h"
+#include "game/perception.h"
+#include "game/profiler.h"
+#include "game/spatial_grid.h"
+#include "game/sweep.h"
+#include <stdbool.h>
+#include <stdint.h>
 
 /**
  * @enum GameState
@@ -22,19 +32,97 @@ typedef enum {
     STATE_RESTARTING    /**< Transition state while players move to kickoff positions. */
 } GameState;
 
+/**
+ * @struct Scene
+ * @brief One match. Created by scene_create(), which places the Scene, its
+ * ball, both teams and every player in a single contiguous block.
+ */
 typedef struct Scene {
     struct Team* first_team;
     struct Team* second_team;
+    int team_size;          /**< Players per team, fixed when the scene is created. */
     struct Ball* ball;
     Field field;
     GameState state;
     float wait_time;        /**< Secondary timer for "celebration" or "reset" delays. */
     float remaining_time;   /**< The main match countdown. */
+    float tick_dt;          /**< Length of the current simulation tick, in seconds. */
+    float friction_dt;      /**< Tick length `friction` was worked out for. */
+    float friction;         /**< Ball velocity factor per tick (FRICTION rescaled to the tick length). */
+    uint64_t seed;          /**< Seed the match was started with; replaying it gives the same match. */
+    struct Rng rng;         /**< Source of every random decision in this match. */
+    struct PlayerBlock players; /**< Contiguous hot state of both teams, used by the physics step. */
+    struct Perception perception; /**< Distances and angles for the coaches, rebuilt every tick. */
+    struct SpatialGrid grid; /**< Player slots by cell, rebuilt whenever a big team needs it. */
+    struct Sweep ball_sweep; /**< First goal or out along the ball's path in the last tick (see game/sweep.h). */
+    struct EventRing events; /**< What happened, for whoever subscribed (see game/events.h). */
+    struct Profiler* profiler; /**< Phase timings (see game/profiler.h), or NULL to not measure. Not owned. */
+    struct Arena arena;     /**< The block this scene and all its entities live in. */
+    size_t arena_mark;      /**< Arena offset right after the Scene; entities start here. */
 } Scene;
 
-void init_scene(Scene* scene);
+/**
+ * @brief Allocates a scene and all its entities in one block and starts a match.
+ * @param team_size Players per team, up to MAX_TEAM_SIZE; 0 means PLAYER_COUNT.
+ * Kits past the coach's PLAYER_COUNT roles reuse them (kit % PLAYER_COUNT).
+ * @param events EVENT_BIT()s to record from the start (see game/events.h), so
+ * the opening kick-off is reported too; 0 for none.
+ * @return NULL if the size is out of range or the allocation failed.
+ * Release with scene_destroy().
+ */
+Scene* scene_create(int team_size, uint64_t seed, uint32_t events);
+
+/**
+ * @brief Starts a new match in an existing scene, reusing its memory.
+ * Keeps the team size. Every Player / Ball / Team pointer taken from the old
+ * match is invalid afterwards.
+ * Event subscriptions carry over, and the opening kick-off is reported.
+ */
+void scene_reset(Scene* scene, uint64_t seed);
+
+/** @brief Frees the scene and everything in it. */
+void scene_destroy(Scene* scene);
+
+/** Where a scene_hash chain starts (the FNV-1a offset basis). */
+#define SCENE_HASH_SEED 14695981039346656037ull
+
+/**
+ * @brief Folds the match state (scores, game state, ball and every player's
+ * position, velocity and state) into `hash`, FNV-1a over the exact bits.
+ * Hashing after every tick fingerprints a whole match: two builds that
+ * played it identically end with the same value.
+ */
+uint64_t scene_hash(const Scene* scene, uint64_t hash);
+
+/**
+ * @brief Ball velocity factor for one tick of `dt` seconds: FRICTION, which is
+ * defined per reference tick, rescaled to the tick length. Costs a powf;
+ * callers cache it per tick length (see Scene.friction).
+ */
+float ball_friction_per_tick(float dt);
+
 void update_and_verify_scene_states(Scene* scene, const float dt);
 void set_piece_out(Scene* scene);
 void set_piece_goal(Scene* scene);
+void scene_store_previous_positions(Scene* scene);
+
+/**
+ * @brief The core "Update" function called by the Main Loop.
+ * * @param dt Delta Time: the length of one simulation tick, in seconds.
+ * Callers should pass a fixed value (see game/timestep.h) rather than the
+ * measured frame time, so a match plays out the same on any display.
+ */
+void update_scene(Scene* scene, float dt);
+
+/**
+ * @name Tick phases
+ * @brief The pieces update_scene is made of, for loops that step many
+ * scenes together (see game/match_batch.h).
+ */
+///@{
+bool scene_advance_clock(Scene* scene, float dt);
+void scene_run_coaches(Scene* scene);
+void scene_apply_referee(Scene* scene, int code);
+///@}
 
 #endif /* ENGINE_GRAPHICS_SCENE_H */
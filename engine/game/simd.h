@@ -0,0 +1,111 @@
+/**
+ * @file simd.h
+ * @brief Tiny SIMD layer shared by the engine's vector kernels (internal).
+ * * vf is a vector of floats, vi of int32s, vm a lane mask. A kernel is
+ * written once against these macros and runs 8-wide with AVX2, 4-wide with
+ * NEON, or one lane at a time otherwise. Only IEEE operations that round
+ * the same way in every width are exposed (no FMA, no approximations), so
+ * a kernel gives the same bits as its scalar fallback.
+ */
+
+#ifndef ENGINE_GAME_SIMD_H
+#define ENGINE_GAME_SIMD_H
+
+#include <math.h>
+#include <stdint.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+typedef __m256 vf;
+typedef __m256i vi;
+typedef __m256 vm;
+#define VW 8
+#define vf_load(p)          _mm256_loadu_ps(p)
+#define vf_store(p, v)      _mm256_storeu_ps((p), (v))
+#define vf_set1(x)          _mm256_set1_ps(x)
+#define vf_add(a, b)        _mm256_add_ps((a), (b))
+#define vf_sub(a, b)        _mm256_sub_ps((a), (b))
+#define vf_mul(a, b)        _mm256_mul_ps((a), (b))
+#define vf_div(a, b)        _mm256_div_ps((a), (b))
+#define vf_sqrt(a)          _mm256_sqrt_ps(a)
+#define vf_neg(a)           _mm256_xor_ps((a), _mm256_set1_ps(-0.0f))
+#define vf_select(m, a, b)  _mm256_blendv_ps((b), (a), (m))
+#define vm_lt(a, b)         _mm256_cmp_ps((a), (b), _CMP_LT_OQ)
+#define vm_le(a, b)         _mm256_cmp_ps((a), (b), _CMP_LE_OQ)
+#define vm_gt(a, b)         _mm256_cmp_ps((a), (b), _CMP_GT_OQ)
+#define vm_ge(a, b)         _mm256_cmp_ps((a), (b), _CMP_GE_OQ)
+#define vm_and(a, b)        _mm256_and_ps((a), (b))
+#define vm_or(a, b)         _mm256_or_ps((a), (b))
+#define vm_load_i32(p) \
+    _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_loadu_si256((const __m256i*)(p)), _mm256_setzero_si256()))
+#define vm_store_i32(p, m) \
+    _mm256_storeu_si256((__m256i*)(p), _mm256_and_si256(_mm256_castps_si256(m), _mm256_set1_epi32(1)))
+#define vi_load(p)          _mm256_loadu_si256((const __m256i*)(p))
+#define vi_store(p, v)      _mm256_storeu_si256((__m256i*)(p), (v))
+#define vi_add(a, b)        _mm256_add_epi32((a), (b))
+#define vi_sub(a, b)        _mm256_sub_epi32((a), (b))
+#define vi_trunc(a)         _mm256_cvttps_epi32(a)
+#define vi_to_vf(a)         _mm256_cvtepi32_ps(a)
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+// AArch64 only: 32-bit NEON has no exact vector divide or square root
+#include <arm_neon.h>
+typedef float32x4_t vf;
+typedef int32x4_t vi;
+typedef uint32x4_t vm;
+#define VW 4
+#define vf_load(p)          vld1q_f32(p)
+#define vf_store(p, v)      vst1q_f32((p), (v))
+#define vf_set1(x)          vdupq_n_f32(x)
+#define vf_add(a, b)        vaddq_f32((a), (b))
+#define vf_sub(a, b)        vsubq_f32((a), (b))
+#define vf_mul(a, b)        vmulq_f32((a), (b))
+#define vf_div(a, b)        vdivq_f32((a), (b))
+#define vf_sqrt(a)          vsqrtq_f32(a)
+#define vf_neg(a)           vnegq_f32(a)
+#define vf_select(m, a, b)  vbslq_f32((m), (a), (b))
+#define vm_lt(a, b)         vcltq_f32((a), (b))
+#define vm_le(a, b)         vcleq_f32((a), (b))
+#define vm_gt(a, b)         vcgtq_f32((a), (b))
+#define vm_ge(a, b)         vcgeq_f32((a), (b))
+#define vm_and(a, b)        vandq_u32((a), (b))
+#define vm_or(a, b)         vorrq_u32((a), (b))
+#define vm_load_i32(p)      vcgtq_s32(vld1q_s32(p), vdupq_n_s32(0))
+#define vm_store_i32(p, m)  vst1q_s32((p), vreinterpretq_s32_u32(vandq_u32((m), vdupq_n_u32(1))))
+#define vi_load(p)          vld1q_s32(p)
+#define vi_store(p, v)      vst1q_s32((p), (v))
+#define vi_add(a, b)        vaddq_s32((a), (b))
+#define vi_sub(a, b)        vsubq_s32((a), (b))
+#define vi_trunc(a)         vcvtq_s32_f32(a)
+#define vi_to_vf(a)         vcvtq_f32_s32(a)
+#else
+typedef float vf;
+typedef int32_t vi;
+typedef int vm;
+#define VW 1
+#define vf_load(p)          (*(p))
+#define vf_store(p, v)      (*(p) = (v))
+#define vf_set1(x)          (x)
+#define vf_add(a, b)        ((a) + (b))
+#define vf_sub(a, b)        ((a) - (b))
+#define vf_mul(a, b)        ((a) * (b))
+#define vf_div(a, b)        ((a) / (b))
+#define vf_sqrt(a)          sqrtf(a)
+#define vf_neg(a)           (-(a))
+#define vf_select(m, a, b)  ((m) ? (a) : (b))
+#define vm_lt(a, b)         ((a) < (b))
+#define vm_le(a, b)         ((a) <= (b))
+#define vm_gt(a, b)         ((a) > (b))
+#define vm_ge(a, b)         ((a) >= (b))
+#define vm_and(a, b)        ((a) & (b))
+#define vm_or(a, b)         ((a) | (b))
+#define vm_load_i32(p)      (*(p) > 0)
+#define vm_store_i32(p, m)  (*(p) = (m) ? 1 : 0)
+#define vi_load(p)          (*(p))
+#define vi_store(p, v)      (*(p) = (v))
+#define vi_add(a, b)        ((a) + (b))
+#define vi_sub(a, b)        ((a) - (b))
+#define vi_trunc(a)         ((int32_t)(a))
+#define vi_to_vf(a)         ((float)(a))
+#endif
+
+#endif
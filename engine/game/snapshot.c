@@ -0,0 +1,49 @@
+#include "snapshot.h"
+#include "core/clock.h"
+#include "entities/ball.h"
+#include "entities/team.h"
+#include "game/scene.h"
+
+static void entity_snapshot(struct EntitySnapshot* out, struct Vec2 prev, struct Vec2 position, float radius) {
+    out->prev_position = prev;
+    out->position = position;
+    out->radius = radius;
+}
+
+void scene_snapshot(const Scene* scene, uint32_t tick, struct SceneSnapshot* out) {
+    out->tick = tick;
+    out->time_ns = clock_now_ns();
+    out->team_size = scene->team_size;
+    const struct Team* teams[2] = {scene->first_team, scene->second_team};
+    for (int t = 0; t < 2; t++) {
+        for (int i = 0; i < scene->team_size; i++) {
+            const Player* p = teams[t]->players[i];
+            entity_snapshot(&out->players[t][i], p->prev_position, p->position, p->radius);
+        }
+        out->score[t] = teams[t]->score;
+    }
+    entity_snapshot(&out->ball, scene->ball->prev_position, scene->ball->position, scene->ball->radius);
+}
+
+void snapshot_buffer_init(struct SnapshotBuffer* buffer, const struct SceneSnapshot* initial) {
+    for (int i = 0; i < 3; i++)
+        buffer->slot[i] = *initial;
+    buffer->back = 0;
+    buffer->middle = 1;
+    buffer->front = 2;
+}
+
+void snapshot_publish(struct SnapshotBuffer* buffer) {
+    // release: the reader that picks this slot up sees everything written to it
+    const unsigned int previous = exchange_acq_rel(&buffer->middle, buffer->back | SNAPSHOT_FRESH);
+    buffer->back = previous & ~SNAPSHOT_FRESH;
+}
+
+const struct SceneSnapshot* snapshot_latest(struct SnapshotBuffer* buffer) {
+    if (load_relaxed(&buffer->middle) & SNAPSHOT_FRESH) {
+        // acquire: the writer's stores to the slot we take are visible
+        const unsigned int newest = exchange_acq_rel(&buffer->middle, buffer->front);
+        buffer->front = newest & ~SNAPSHOT_FRESH;
+    }
+    return &buffer->slot[buffer->front];
+}
@@ -0,0 +1,88 @@
+/**
+ * @file snapshot.h
+ * @brief What the viewer needs of a Scene, handed between threads through a triple buffer.
+ * * A SceneSnapshot is a copy of everything drawn on screen: where every
+ * player and the ball were on the last two ticks, and the score. The
+ * simulation thread fills one after each tick and publishes it; the render
+ * thread picks up the latest whenever it draws a frame. Neither ever waits
+ * for the other: with three slots the writer always has a free one, the
+ * reader keeps the one it's drawing, and the third is the newest finished
+ * snapshot. A snapshot the reader didn't get to in time is simply skipped.
+ *
+ * Example:
+ * @code
+ *   // simulation thread
+ *   update_scene(scene, dt);
+ *   scene_snapshot(scene, ++tick, snapshot_back(&buffer));
+ *   snapshot_publish(&buffer);
+ *
+ *   // render thread
+ *   const struct SceneSnapshot* latest = snapshot_latest(&buffer);
+ * @endcode
+ */
+
+#ifndef ENGINE_GAME_SNAPSHOT_H
+#define ENGINE_GAME_SNAPSHOT_H
+
+#include "core/atomic.h"
+#include "core/constants.h"
+#include "core/vec2.h"
+
+#include <stdint.h>
+
+struct Scene;
+
+/**
+ * @struct EntitySnapshot
+ */
+struct EntitySnapshot {
+    struct Vec2 prev_position;  /**< On the tick before. */
+    struct Vec2 position;
+    float radius;
+};
+
+/**
+ * @struct SceneSnapshot
+ */
+struct SceneSnapshot {
+    uint32_t tick;              /**< Ticks played when it was taken. */
+    uint64_t time_ns;           /**< clock_now_ns() when it was taken. */
+    int team_size;
+    struct EntitySnapshot players[2][MAX_TEAM_SIZE];    /**< [0] first team, [1] second team, by kit. */
+    struct EntitySnapshot ball;
+    unsigned int score[2];
+};
+
+/**
+ * @struct SnapshotBuffer
+ * @brief Single-writer / single-reader triple buffer.
+ */
+struct SnapshotBuffer {
+    struct SceneSnapshot slot[3];
+    unsigned int back;                          /**< Writer's slot. */
+    char pad0[CACHE_LINE - sizeof(unsigned int)];
+    unsigned int middle;                        /**< Newest finished slot, | SNAPSHOT_FRESH if unread. */
+    char pad1[CACHE_LINE - sizeof(unsigned int)];
+    unsigned int front;                         /**< Reader's slot. */
+};
+
+#define SNAPSHOT_FRESH 4u
+
+/** @brief Copies what's drawn out of the scene, `tick` ticks in (time_ns is set to now). */
+void scene_snapshot(const struct Scene* scene, uint32_t tick, struct SceneSnapshot* out);
+
+/** @brief Starts with `initial` in every slot, so the reader always has something to draw. */
+void snapshot_buffer_init(struct SnapshotBuffer* buffer, const struct SceneSnapshot* initial);
+
+/** @brief The slot the writer fills next. Only the writer may touch it. */
+static inline struct SceneSnapshot* snapshot_back(struct SnapshotBuffer* buffer) {
+    return &buffer->slot[buffer->back];
+}
+
+/** @brief Writer: hands the back slot over as the newest snapshot. */
+void snapshot_publish(struct SnapshotBuffer* buffer);
+
+/** @brief Reader: the newest published snapshot, valid until the next call. */
+const struct SceneSnapshot* snapshot_latest(struct SnapshotBuffer* buffer);
+
+#endif
@@ -0,0 +1,125 @@
+#include "spatial_grid.h"
+
+#include <math.h>
+#include <string.h>
+
+#define GRID_ALIGN 32
+
+static size_t int_array_bytes(int count) {
+    return arena_align_up((size_t)count * sizeof(int), GRID_ALIGN);
+}
+
+size_t spatial_grid_bytes(int capacity) {
+    return int_array_bytes(GRID_CELLS + 1) + 2 * int_array_bytes(capacity) + GRID_ALIGN;
+}
+
+int spatial_grid_init(struct SpatialGrid* grid, struct Arena* arena, int capacity) {
+    memset(grid, 0, sizeof(*grid));
+    grid->capacity = capacity;
+    grid->start = arena_alloc(arena, int_array_bytes(GRID_CELLS + 1), GRID_ALIGN);
+    grid->order = arena_alloc(arena, int_array_bytes(capacity), GRID_ALIGN);
+    grid->cell = arena_alloc(arena, int_array_bytes(capacity), GRID_ALIGN);
+    return grid->cell ? 0 : -1;
+}
+
+void spatial_grid_build(struct SpatialGrid* grid, const float* x, const float* y,
+                        struct Player* const* view, int first, int last) {
+    int* start = grid->start;
+    int* cell = grid->cell;
+    if (last - first > grid->capacity) last = first + grid->capacity;
+    grid->first = first;
+    grid->last = last;
+    grid->min_x = grid->min_y = GRID_CELLS;
+    grid->max_x = grid->max_y = -1;
+
+    // count per cell, prefix-sum to the end of each cell, then fill backwards:
+    // every cell ends up with its slots in ascending order
+    memset(start, 0, sizeof(int) * (GRID_CELLS + 1));
+    int placed = 0;
+    for (int i = first; i < last; i++) {
+        const int c = (!view || view[i]) ? spatial_grid_cell(x[i], y[i]) : -1;
+        cell[i - first] = c;
+        if (c < 0) continue;
+        start[c]++;
+        placed++;
+        const int cx = c % GRID_COLUMNS, cy = c / GRID_COLUMNS;
+        if (cx < grid->min_x) grid->min_x = cx;
+        if (cx > grid->max_x) grid->max_x = cx;
+        if (cy < grid->min_y) grid->min_y = cy;
+        if (cy > grid->max_y) grid->max_y = cy;
+    }
+    for (int c = 1; c < GRID_CELLS; c++)
+        start[c] += start[c - 1];
+    start[GRID_CELLS] = placed;
+    for (int i = last - 1; i >= first; i--)
+        if (cell[i - first] >= 0)
+            grid->order[--start[cell[i - first]]] = i;
+}
+
+static int max_int(int a, int b) { return a > b ? a : b; }
+static int min_int(int a, int b) { return a < b ? a : b; }
+
+struct Nearest {
+    int slot;
+    float d;            // squared distance
+};
+
+static void scan_cell(const struct SpatialGrid* grid, const float* x, const float* y, int self,
+                      int c, struct Nearest* best) {
+    const float px = x[self], py = y[self];
+    for (int k = grid->start[c]; k < grid->start[c + 1]; k++) {
+        const int j = grid->order[k];
+        if (j == self) continue;
+        const float dx = x[j] - px;
+        const float dy = y[j] - py;
+        const float d = dx * dx + dy * dy;
+        if (d < best->d || (d == best->d && j < best->slot)) {
+            best->d = d;
+            best->slot = j;
+        }
+    }
+}
+
+int spatial_grid_nearest(const struct SpatialGrid* grid, const float* x, const float* y, int self) {
+    if (grid->min_x > grid->max_x) return -1;
+
+    const float px = x[self], py = y[self];
+    const int home = spatial_grid_cell(px, py);
+    const int hx = home % GRID_COLUMNS, hy = home / GRID_COLUMNS;
+
+    // rings of cells around home, only where the grid holds anyone
+    const int first_ring = max_int(max_int(grid->min_x - hx, hx - grid->max_x),
+                                   max_int(max_int(grid->min_y - hy, hy - grid->max_y), 0));
+    const int last_ring = max_int(max_int(hx - grid->min_x, grid->max_x - hx),
+                                  max_int(hy - grid->min_y, grid->max_y - hy));
+
+    struct Nearest best = {-1, INFINITY};
+    for (int ring = first_ring; ring <= last_ring; ring++) {
+        if (ring > 0 && best.slot >= 0) {
+            // everything from here on is outside the square of the inner rings
+            const float inner = fminf(fminf(px - (float)((hx - ring + 1) * GRID_CELL),
+                                            (float)((hx + ring) * GRID_CELL) - px),
+                                      fminf(py - (float)((hy - ring + 1) * GRID_CELL),
+                                            (float)((hy + ring) * GRID_CELL) - py));
+            if (inner > 0.0f && best.d < inner * inner)
+                break;
+        }
+
+        const int top = max_int(hy - ring, grid->min_y), bottom = min_int(hy + ring, grid->max_y);
+        const int left = max_int(hx - ring, grid->min_x), right = min_int(hx + ring, grid->max_x);
+        for (int cy = top; cy <= bottom; cy++) {
+            if (cy == hy - ring || cy == hy + ring) {
+                // top and bottom rows of the ring are whole
+                for (int cx = left; cx <= right; cx++)
+                    scan_cell(grid, x, y, self, cy * GRID_COLUMNS + cx, &best);
+            } else {
+                // the rows between only have their two ends
+                if (hx - ring >= left)
+                    scan_cell(grid, x, y, self, cy * GRID_COLUMNS + hx - ring, &best);
+                if (hx + ring <= right)
+                    scan_cell(grid, x, y, self, cy * GRID_COLUMNS + hx + ring, &best);
+            }
+        }
+    }
+    return best.slot;
+}
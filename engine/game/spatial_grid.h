@@ -0,0 +1,88 @@
+/**
+ * @file spatial_grid.h
+ * @brief Uniform grid over the window, for "who is near this player" questions.
+ * * Checking every player against every other one is fine for 12 players
+ * and hopeless for a few hundred. The grid buckets a range of player slots
+ * by cell (a counting sort, O(players + cells) per build), so a query only
+ * looks at the few cells around a point.
+ *
+ * The grid holds slot numbers (see player_block.h), not positions: queries
+ * take the same x / y arrays the grid was built from.
+ *
+ * Example:
+ * @code
+ *   // nearest opponent of a first-team player
+ *   spatial_grid_build(&grid, per->x, per->y, block->view, block->team_size, block->count);
+ *   int opponent = spatial_grid_nearest(&grid, per->x, per->y, slot);
+ * @endcode
+ */
+
+#ifndef ENGINE_GAME_SPATIAL_GRID_H
+#define ENGINE_GAME_SPATIAL_GRID_H
+
+#include "core/arena.h"
+#include "core/constants.h"
+
+#include <stddef.h>
+
+struct Player;
+
+#define GRID_CELL 64        /**< Cell size in pixels; at least one player diameter. */
+#define GRID_COLUMNS ((SCREEN_WIDTH + GRID_CELL - 1) / GRID_CELL)
+#define GRID_ROWS ((SCREEN_HEIGHT + GRID_CELL - 1) / GRID_CELL)
+#define GRID_CELLS (GRID_COLUMNS * GRID_ROWS)
+
+/**
+ * Below these many slots, checking every pair beats building a grid (see
+ * the grid/ benchmarks in bench/bench.c). Separation only looks at the
+ * neighbouring cells and pays off early; a nearest search may have to walk
+ * out to the other end of the pitch.
+ */
+#define GRID_SEPARATE_MIN_SLOTS 24
+#define GRID_NEAREST_MIN_SLOTS 96
+
+/**
+ * @struct SpatialGrid
+ * @brief Slots sorted by cell: cell c holds order[start[c]] .. order[start[c + 1] - 1].
+ */
+struct SpatialGrid {
+    int* start;         /**< GRID_CELLS + 1 entries. */
+    int* order;         /**< Slots, by cell, ascending within a cell. */
+    int* cell;          /**< Cell of every slot in the range, -1 for empty slots. */
+    int capacity;       /**< Slots the grid can hold. */
+    int first;          /**< The range of slots it was built from. */
+    int last;
+    int min_x, max_x;   /**< Columns and rows that hold anyone; min > max when empty. */
+    int min_y, max_y;
+};
+
+/** @brief Arena bytes spatial_grid_init needs for `capacity` slots, padding included. */
+size_t spatial_grid_bytes(int capacity);
+
+/** @return 0 on success, -1 if the arena is too small. */
+int spatial_grid_init(struct SpatialGrid* grid, struct Arena* arena, int capacity);
+
+/** @brief The cell a point falls in; points off the window go to the nearest edge cell. */
+static inline int spatial_grid_cell(float x, float y) {
+    int cx = (int)(x / GRID_CELL), cy = (int)(y / GRID_CELL);
+    cx = cx < 0 ? 0 : (cx >= GRID_COLUMNS ? GRID_COLUMNS - 1 : cx);
+    cy = cy < 0 ? 0 : (cy >= GRID_ROWS ? GRID_ROWS - 1 : cy);
+    return cy * GRID_COLUMNS + cx;
+}
+
+/**
+ * @brief Sorts slots first .. last - 1 into cells; slots whose view is NULL are left out.
+ * @param view May itself be NULL: every slot in the range is occupied.
+ */
+void spatial_grid_build(struct SpatialGrid* grid, const float* x, const float* y,
+                        struct Player* const* view, int first, int last);
+
+/**
+ * @brief The slot in the grid closest to slot `self` (which needn't be in
+ * it), other than `self`. Ties go to the lower slot, as a scan in slot
+ * order would.
+ * @return The slot, or -1 if the grid holds no one else.
+ */
+int spatial_grid_nearest(const struct SpatialGrid* grid, const float* x, const float* y, int self);
+
+#endif
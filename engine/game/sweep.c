@@ -0,0 +1,98 @@
+#include "sweep.h"
+#include "core/constants.h"
+
+#include <math.h>
+
+float sweep_line(float a0, float a1, float line, int side) {
+    const float start = side * (a0 - line);     // > 0 once past
+    const float end = side * (a1 - line);
+    if (start > 0.0f) return 0.0f;
+    if (end <= 0.0f) return -1.0f;
+    return -start / (end - start);
+}
+
+float sweep_point(struct Vec2 from, struct Vec2 to, float radius, struct Vec2 point) {
+    // |from + t * d - point| = radius, the smaller root
+    const float dx = to.x - from.x, dy = to.y - from.y;
+    const float fx = from.x - point.x, fy = from.y - point.y;
+    const float a = dx * dx + dy * dy;
+    const float b = fx * dx + fy * dy;
+    const float c = fx * fx + fy * fy - radius * radius;
+    if (c <= 0.0f || a == 0.0f || b >= 0.0f) return -1.0f;   // touching already, or moving away
+    const float disc = b * b - a * c;
+    if (disc < 0.0f) return -1.0f;
+    const float t = (-b - sqrtf(disc)) / a;
+    return t <= 1.0f ? t : -1.0f;
+}
+
+static struct Vec2 along(struct Vec2 from, struct Vec2 to, float t) {
+    return (struct Vec2){from.x + (to.x - from.x) * t, from.y + (to.y - from.y) * t};
+}
+
+/* earlier of two times, where -1 means never */
+static float first(float a, float b) {
+    if (a < 0.0f) return b;
+    if (b < 0.0f) return a;
+    return a < b ? a : b;
+}
+
+/* Whole ball over the goal line at `line` at time `t` (-1: never), between
+ * the posts and without touching one first. */
+static bool scores(struct Vec2 from, struct Vec2 to, float radius, float line, float t) {
+    if (t < 0.0f) return false;
+    const float top = (float)(CENTER_Y - GOAL_HEIGHT / 2);
+    const float bottom = (float)(CENTER_Y + GOAL_HEIGHT / 2);
+    const float y = along(from, to, t).y;
+    if (y - radius < top || y + radius > bottom) return false;
+    const float post = first(sweep_point(from, to, radius, (struct Vec2){line, top}),
+                             sweep_point(from, to, radius, (struct Vec2){line, bottom}));
+    return post < 0.0f || post >= t;
+}
+
+struct Sweep sweep_ball(struct Vec2 from, struct Vec2 to, float radius) {
+    const float left_line = PITCH_X;
+    const float right_line = PITCH_X + PITCH_W;
+    const float top_line = PITCH_Y;
+    const float bottom_line = PITCH_Y + PITCH_H;
+
+    // the whole ball is past a line once its centre is a radius beyond it
+    const float left = sweep_line(from.x, to.x, left_line - radius, -1);
+    const float right = sweep_line(from.x, to.x, right_line + radius, 1);
+    const float top = sweep_line(from.y, to.y, top_line - radius, -1);
+    const float bottom = sweep_line(from.y, to.y, bottom_line + radius, 1);
+    const float out = first(first(left, right), first(top, bottom));
+
+    // goals first: a goal is technically out, too
+    float goal = -1.0f;
+    int scorer = 0;
+    if (scores(from, to, radius, right_line, right)) {
+        goal = right;
+        scorer = 1;
+    }
+    if (scores(from, to, radius, left_line, left) && (goal < 0.0f || left < goal)) {
+        goal = left;
+        scorer = 2;
+    }
+
+    struct Sweep s = {.kind = SWEEP_NONE, .t = 1.0f, .point = to};
+    if (goal >= 0.0f && goal <= out) {
+        s.kind = SWEEP_GOAL;
+        s.scorer = scorer;
+        s.t = goal;
+    } else if (out >= 0.0f) {
+        s.kind = SWEEP_OUT;
+        s.t = out;
+    }
+    if (s.kind != SWEEP_NONE)
+        s.point = along(from, to, s.t);
+
+    const float goal_top = (float)(CENTER_Y - GOAL_HEIGHT / 2);
+    const float goal_bottom = (float)(CENTER_Y + GOAL_HEIGHT / 2);
+    const struct Vec2 posts[4] = {{left_line, goal_top}, {left_line, goal_bottom},
+                                  {right_line, goal_top}, {right_line, goal_bottom}};
+    for (int i = 0; i < 4 && s.kind != SWEEP_GOAL; i++) {
+        const float hit = sweep_point(from, to, radius, posts[i]);
+        if (hit >= 0.0f && hit < s.t) s.post = true;
+    }
+    return s;
+}
@@ -0,0 +1,72 @@
+/**
+ * @file sweep.h
+ * @brief Where, during a tick, the ball crossed a goal line, hit a post or left the pitch.
+ * * Checking only where the ball ends up misses things once it moves far in
+ * one tick: an 8000 px/s shot at dt = 1/30 covers 270 px, more than the net
+ * is deep, and at coarser steps the ball can cross the goal line inside the
+ * mouth and end up beside the net, or the other way round. These tests take
+ * the whole segment the ball's centre travelled and say when it first
+ * crossed something, as a fraction t of the tick, and where.
+ *
+ * The rules are those of goal() and out() in referee.c: the whole ball has
+ * to be past a line, and for a goal also between the posts. A ball that
+ * touches a post on its way in doesn't score.
+ *
+ * Pass the path before any bounce off the window edges: the pitch lines
+ * are all at least PITCH_MARGIN inside the window, so everything here
+ * happens before the ball could reach one.
+ *
+ * Example:
+ * @code
+ *   const struct Vec2 from = ball->position;
+ *   const struct Vec2 to = {from.x + ball->velocity.x * dt, from.y + ball->velocity.y * dt};
+ *   const struct Sweep s = sweep_ball(from, to, ball->radius);
+ *   if (s.kind == SWEEP_GOAL) ...  // team s.scorer scored, s.t * dt seconds into the tick
+ * @endcode
+ */
+
+#ifndef ENGINE_GAME_SWEEP_H
+#define ENGINE_GAME_SWEEP_H
+
+#include "core/vec2.h"
+
+#include <stdbool.h>
+
+/**
+ * @enum SweepKind
+ */
+typedef enum {
+    SWEEP_NONE,     /**< The ball stayed in play. */
+    SWEEP_GOAL,     /**< Whole ball over a goal line between the posts. */
+    SWEEP_OUT       /**< Whole ball over a touch line or a goal line outside the posts. */
+} SweepKind;
+
+/**
+ * @struct Sweep
+ * @brief The first thing the ball's path crossed.
+ */
+struct Sweep {
+    SweepKind kind;
+    int scorer;         /**< 1 (right goal) or 2 (left goal) for SWEEP_GOAL, else 0. */
+    bool post;          /**< The ball touched a post before `t`. */
+    float t;            /**< Fraction of the path, 0 .. 1, at which it happened. */
+    struct Vec2 point;  /**< Ball centre at that moment. */
+};
+
+/**
+ * @brief When a coordinate going from a0 to a1 first gets past `line`.
+ * @param side -1 for below the line, 1 for above it.
+ * @return 0 .. 1, 0 if a0 is already past, or -1 if it never gets there.
+ */
+float sweep_line(float a0, float a1, float line, int side);
+
+/**
+ * @brief When a ball of `radius` moving from `from` to `to` first touches `point`.
+ * @return 0 .. 1, or -1 if it doesn't, or was touching it already at `from`.
+ */
+float sweep_point(struct Vec2 from, struct Vec2 to, float radius, struct Vec2 point);
+
+/** @brief The first goal or out along the path, with the referee's rules. */
+struct Sweep sweep_ball(struct Vec2 from, struct Vec2 to, float radius);
+
+#endif
@@ -0,0 +1,34 @@
+#include "timestep.h"
+#include "core/constants.h"
+
+void fixed_step_init(struct FixedStep* step, int tick_rate) {
+    if (tick_rate <= 0)
+        tick_rate = SIM_TICK_RATE;
+    step->tick_dt = 1.0f / (float)tick_rate;
+    step->accumulator = 0.0;
+    step->max_ticks = 8;
+}
+
+int fixed_step_advance(struct FixedStep* step, double frame_seconds) {
+    if (frame_seconds > 0.0)
+        step->accumulator += frame_seconds;
+
+    int ticks = 0;
+    while (step->accumulator >= step->tick_dt) {
+        step->accumulator -= step->tick_dt;
+        if (++ticks == step->max_ticks) {
+            // too far behind: forget the rest instead of catching up
+            if (step->accumulator >= step->tick_dt)
+                step->accumulator = 0.0;
+            break;
+        }
+    }
+    return ticks;
+}
+
+float fixed_step_alpha(const struct FixedStep* step) {
+    float alpha = (float)(step->accumulator / step->tick_dt);
+    if (alpha < 0.0f) alpha = 0.0f;
+    if (alpha > 1.0f) alpha = 1.0f;
+    return alpha;
+}
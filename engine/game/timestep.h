@@ -0,0 +1,43 @@
+/**
+ * @file timestep.h
+ * @brief Fixed-timestep accumulator that decouples simulation from frames.
+ * * The simulation always advances in steps of exactly `tick_dt` seconds, no
+ * matter how long a frame took. Wall time is collected in an accumulator and
+ * spent one tick at a time; whatever is left over becomes the interpolation
+ * factor the renderer uses to draw between the last two ticks.
+ */
+
+#ifndef ENGINE_GAME_TIMESTEP_H
+#define ENGINE_GAME_TIMESTEP_H
+
+/**
+ * @struct FixedStep
+ * @brief Accumulator state for one simulation clock.
+ */
+struct FixedStep {
+    float tick_dt;          /**< Simulated seconds per tick (1 / tick rate). */
+    double accumulator;     /**< Wall time not yet consumed by a tick. */
+    int max_ticks;          /**< Ticks allowed per frame before time is dropped. */
+};
+
+/**
+ * @brief Prepares a clock running at `tick_rate` ticks per second.
+ * Non-positive rates fall back to SIM_TICK_RATE.
+ */
+void fixed_step_init(struct FixedStep* step, int tick_rate);
+
+/**
+ * @brief Adds a frame's wall time and returns how many ticks to run now.
+ * * If the frame was so long that more than `max_ticks` are owed, the excess
+ * is dropped: the match slows down instead of spiralling into ever longer
+ * frames. Each tick still uses the same `tick_dt`, so results don't change.
+ */
+int fixed_step_advance(struct FixedStep* step, double frame_seconds);
+
+/**
+ * @brief Fraction (0..1) of a tick left in the accumulator.
+ * 0 means "draw the previous tick", 1 means "draw the latest tick".
+ */
+float fixed_step_alpha(const struct FixedStep* step);
+
+#endif
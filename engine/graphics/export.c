@@ -0,0 +1,154 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "export.h"
+#include "core/log.h"
+#include "core/thread_pool.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <SDL_image.h>
+
+#define BUFFERS_PER_WORKER 2    // one being encoded, one waiting
+
+struct ExportFrame {
+    struct FrameExporter* exporter;
+    unsigned char* pixels;      // RGB24, tightly packed
+    unsigned long number;
+    bool busy;                  // captured and not written yet (guarded by exporter->lock)
+};
+
+struct FrameExporter {
+    struct ThreadPool* pool;
+    char directory[400];
+    ExportFormat format;
+    int width;
+    int height;
+    unsigned long captured;
+
+    pthread_mutex_t lock;
+    pthread_cond_t freed;       // signalled when a frame buffer is written
+    unsigned long failures;
+
+    struct ExportFrame* frames;
+    int frame_count;
+};
+
+static bool write_ppm(const struct ExportFrame* frame, const char* path) {
+    const struct FrameExporter* e = frame->exporter;
+    FILE* out = fopen(path, "wb");
+    if (!out) return false;
+    fprintf(out, "P6\n%d %d\n255\n", e->width, e->height);
+    const size_t size = (size_t)e->width * e->height * 3;
+    const bool ok = fwrite(frame->pixels, 1, size, out) == size;
+    return fclose(out) == 0 && ok;
+}
+
+static bool write_png(const struct ExportFrame* frame, const char* path) {
+    const struct FrameExporter* e = frame->exporter;
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormatFrom(frame->pixels, e->width, e->height, 24,
+                                                              e->width * 3, SDL_PIXELFORMAT_RGB24);
+    if (!surface) return false;
+    const bool ok = IMG_SavePNG(surface, path) == 0;
+    SDL_FreeSurface(surface);
+    return ok;
+}
+
+static void encode_task(void* arg, int worker) {
+    (void)worker;
+    struct ExportFrame* frame = arg;
+    struct FrameExporter* e = frame->exporter;
+
+    char path[512];
+    snprintf(path, sizeof(path), "%s/frame_%06lu.%s", e->directory, frame->number,
+             e->format == EXPORT_PPM ? "ppm" : "png");
+    const bool ok = e->format == EXPORT_PPM ? write_ppm(frame, path) : write_png(frame, path);
+    if (!ok)
+        LOG_ERROR(LOG_RENDER, "can't write %s", path);
+
+    pthread_mutex_lock(&e->lock);
+    if (!ok) e->failures++;
+    frame->busy = false;
+    pthread_cond_signal(&e->freed);
+    pthread_mutex_unlock(&e->lock);
+}
+
+struct FrameExporter* frame_exporter_create(const struct ExportConfig* config, int width, int height) {
+    struct FrameExporter* e = calloc(1, sizeof(*e));
+    if (!e) return NULL;
+    snprintf(e->directory, sizeof(e->directory), "%s", config->directory ? config->directory : ".");
+    e->format = config->format;
+    e->width = width;
+    e->height = height;
+
+    e->pool = thread_pool_create(config->threads);
+    if (!e->pool) {
+        free(e);
+        return NULL;
+    }
+    e->frame_count = thread_pool_size(e->pool) * BUFFERS_PER_WORKER;
+    e->frames = calloc(e->frame_count, sizeof(struct ExportFrame));
+    bool ok = e->frames != NULL;
+    for (int i = 0; ok && i < e->frame_count; i++) {
+        e->frames[i].exporter = e;
+        e->frames[i].pixels = malloc((size_t)width * height * 3);
+        ok = e->frames[i].pixels != NULL;
+    }
+    if (!ok) {
+        thread_pool_destroy(e->pool);
+        for (int i = 0; e->frames && i < e->frame_count; i++)
+            free(e->frames[i].pixels);
+        free(e->frames);
+        free(e);
+        return NULL;
+    }
+    pthread_mutex_init(&e->lock, NULL);
+    pthread_cond_init(&e->freed, NULL);
+    return e;
+}
+
+int frame_exporter_capture(struct FrameExporter* e, SDL_Renderer* r) {
+    // a free buffer; if the encoders are all behind, wait for one
+    struct ExportFrame* frame = NULL;
+    pthread_mutex_lock(&e->lock);
+    while (!frame) {
+        for (int i = 0; i < e->frame_count && !frame; i++)
+            if (!e->frames[i].busy) frame = &e->frames[i];
+        if (!frame)
+            pthread_cond_wait(&e->freed, &e->lock);
+    }
+    frame->busy = true;
+    pthread_mutex_unlock(&e->lock);
+
+    if (SDL_RenderReadPixels(r, NULL, SDL_PIXELFORMAT_RGB24, frame->pixels, e->width * 3) != 0) {
+        LOG_ERROR(LOG_RENDER, "can't read the frame back: %s", SDL_GetError());
+        pthread_mutex_lock(&e->lock);
+        frame->busy = false;
+        pthread_mutex_unlock(&e->lock);
+        return -1;
+    }
+    frame->number = e->captured++;
+    if (thread_pool_submit(e->pool, encode_task, frame) != 0)
+        encode_task(frame, 0);  // no room in the queue: write it here
+    return 0;
+}
+
+unsigned long frame_exporter_frames(const struct FrameExporter* e) {
+    return e->captured;
+}
+
+unsigned long frame_exporter_destroy(struct FrameExporter* e) {
+    if (!e) return 0;
+    thread_pool_destroy(e->pool);   // finishes the queued frames
+    const unsigned long failures = e->failures;
+    for (int i = 0; i < e->frame_count; i++)
+        free(e->frames[i].pixels);
+    free(e->frames);
+    pthread_cond_destroy(&e->freed);
+    pthread_mutex_destroy(&e->lock);
+    free(e);
+    return failures;
+}
@@ -0,0 +1,64 @@
+/**
+ * @file export.h
+ * @brief Writes rendered frames to numbered image files, encoded on a thread pool.
+ * * frame_exporter_capture reads the current frame out of a renderer (usually
+ * an offscreen one, see renderer_init_offscreen) into one of a few frame
+ * buffers and returns; a pool worker encodes it and writes
+ * DIRECTORY/frame_000000.png (or .ppm), frame_000001.png, ... Encoding runs
+ * in parallel with the match and with each other. Only when every buffer is
+ * still waiting to be written does a capture wait for one to come free.
+ *
+ * Example:
+ * @code
+ *   struct Renderer renderer;
+ *   renderer_init_offscreen(&renderer);
+ *   const struct ExportConfig config = {.directory = "frames", .format = EXPORT_PNG};
+ *   struct FrameExporter* exporter = frame_exporter_create(&config, SCREEN_WIDTH, SCREEN_HEIGHT);
+ *   ... renderer_draw_snapshot(&renderer, &snapshot, 1.0f);
+ *       frame_exporter_capture(exporter, renderer.sdl_renderer); ...
+ *   frame_exporter_destroy(exporter);   // waits for the last frames
+ * @endcode
+ */
+#ifndef ENGINE_GRAPHICS_EXPORT_H
+#define ENGINE_GRAPHICS_EXPORT_H
+
+#include <SDL2/SDL.h>
+
+/**
+ * @enum ExportFormat
+ */
+typedef enum {
+    EXPORT_PNG,     /**< Compressed; most of the encoding time. */
+    EXPORT_PPM      /**< Raw binary RGB (P6); fast, big. */
+} ExportFormat;
+
+/**
+ * @struct ExportConfig
+ */
+struct ExportConfig {
+    const char* directory;  /**< Must exist. */
+    ExportFormat format;
+    int threads;            /**< Encoder threads; non-positive means one per CPU. */
+};
+
+struct FrameExporter;
+
+/** @return NULL if out of memory or no thread could be started. */
+struct FrameExporter* frame_exporter_create(const struct ExportConfig* config, int width, int height);
+
+/**
+ * @brief Reads the current frame out of `r` and queues it for writing.
+ * @return 0 on success, -1 if the frame couldn't be read.
+ */
+int frame_exporter_capture(struct FrameExporter* exporter, SDL_Renderer* r);
+
+/** @brief Frames captured so far. */
+unsigned long frame_exporter_frames(const struct FrameExporter* exporter);
+
+/**
+ * @brief Waits until every captured frame is written, then frees everything.
+ * @return How many frames couldn't be written.
+ */
+unsigned long frame_exporter_destroy(struct FrameExporter* exporter);
+
+#endif
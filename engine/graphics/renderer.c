@@ -1,12 +1,16 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <math.h>
 #include <SDL_image.h>
 
 #include "renderer.h"
 #include "core/constants.h"
-#include "logic/referee.h"
-#include "entities/team.h"
-#include "entities/ball.h"
+#include "core/log.h"
+
+// sprite cell of a player's icon; team 0 is red, team 1 blue. There are
+// PLAYER_COUNT icons per team; bigger teams wear them again
+#define ICON_SPRITE(team, i) (1 + (team) * PLAYER_COUNT + (i) % PLAYER_COUNT)
 
 // for scoreboard
 static void draw_filled_rect(SDL_Renderer* r, int x, int y, int w, int h, SDL_Color color) {
@@ -92,58 +96,87 @@ static void draw_pitch_markings(SDL_Renderer* r) {
     SDL_RenderDrawRect(r, &right_box);
 }
 
-static void render_text(SDL_Renderer* r, TTF_Font* font, const char* text, int x, int y, SDL_Color color) {
-    if (!font || !text) return;
-
-    SDL_Surface* surface = TTF_RenderText_Solid(font, text, color);
-    if (!surface) {
-        SDL_Log("TTF_RenderText_Solid failed: %s", TTF_GetError());
-        return;
+/**
+ * @brief (Re)creates the pitch texture and draws the markings into it.
+ * Everything in draw_pitch_markings is static, so it is drawn once into a
+ * render target and copied to the screen each frame. Returns false (and
+ * the caller draws the markings directly) if that isn't possible.
+ */
+static bool build_pitch(struct Renderer* r) {
+    SDL_Renderer* sdl = r->sdl_renderer;
+    if (!r->pitch) {
+        if (!SDL_RenderTargetSupported(sdl))
+            return false;
+        r->pitch = SDL_CreateTexture(sdl, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET,
+                                     SCREEN_WIDTH, SCREEN_HEIGHT);
+        if (!r->pitch) {
+            LOG_WARN(LOG_RENDER, "can't cache the pitch, drawing it every frame: %s", SDL_GetError());
+            return false;
+        }
+        SDL_SetTextureBlendMode(r->pitch, SDL_BLENDMODE_NONE);  // opaque background
     }
-
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(r, surface);
-    if (!texture) {
-        SDL_Log("SDL_CreateTextureFromSurface failed: %s", SDL_GetError());
+    if (SDL_SetRenderTarget(sdl, r->pitch) != 0) {
+        SDL_DestroyTexture(r->pitch);
+        r->pitch = NULL;
+        return false;
     }
+    SDL_SetRenderDrawColor(sdl, 0, 0, 0, 255);
+    SDL_RenderClear(sdl);
+    SDL_SetRenderDrawBlendMode(sdl, SDL_BLENDMODE_BLEND);  // the nets are translucent
+    draw_pitch_markings(sdl);
+    SDL_SetRenderTarget(sdl, NULL);
+    r->pitch_dirty = false;
+    return true;
+}
 
-    // Set the destination rectangle for drawing
-    SDL_Rect dst = { x, y, surface->w, surface->h };
-    
-    // Draw the texture and clean up
-    if (texture) {
-        SDL_RenderCopy(r, texture, NULL, &dst);
-        SDL_DestroyTexture(texture);
-    }
-    
-    SDL_FreeSurface(surface);
+static void build_label(struct Renderer* r) {
+    text_batch_clear(&r->label_text);
+    text_batch_add(&r->label_text, &r->glyphs, r->timeline_label,
+                   20, TIMELINE_Y - 8, (SDL_Color){255, 255, 255, 255});
 }
 
-static void draw_circle(SDL_Renderer* r, int cx, int cy, int radius) {
-    for (int w = 0; w < radius * 2; w++) {
-        for (int h = 0; h < radius * 2; h++) {
-            const int dx = w - radius;
-            const int dy = h - radius;
-            if (dx * dx + dy * dy <= radius * radius) {
-                SDL_RenderDrawPoint(r, cx + dx, cy + dy);
-            }
-        }
+void renderer_handle_event(struct Renderer* r, const SDL_Event* event) {
+    if (event->type == SDL_RENDER_DEVICE_RESET) {
+        // the textures went with the device
+        if (r->pitch) SDL_DestroyTexture(r->pitch);
+        r->pitch = NULL;
+        r->pitch_dirty = true;
+        glyph_atlas_destroy(&r->glyphs);
+        glyph_atlas_build(&r->glyphs, r->sdl_renderer, r->font);
+        sprite_atlas_upload(&r->sprites, r->sdl_renderer);
+        r->shown_score[0] = r->shown_score[1] = -1;
+        build_label(r);
+    } else if (event->type == SDL_RENDER_TARGETS_RESET ||
+               (event->type == SDL_WINDOWEVENT && event->window.event == SDL_WINDOWEVENT_SIZE_CHANGED)) {
+        r->pitch_dirty = true;
     }
 }
 
 /**
- * @brief Initializes the SDL window and renderer.
+ * @brief Initializes the SDL window and renderer, or with `offscreen` a
+ * software renderer drawing into r->canvas.
  * @param r Pointer to Renderer struct to initialize.
  * @return 0 on success.
  */
-int renderer_init(struct Renderer* r) {
-    if (SDL_Init(SDL_INIT_VIDEO) != 0) {
-        SDL_Log("SDL_Init failed: %s", SDL_GetError());
+static int init(struct Renderer* r, bool offscreen) {
+    r->window = NULL;
+    r->canvas = NULL;
+    r->timeline = -1.0f;
+    r->timeline_label[0] = '\0';
+    r->pitch = NULL;
+    r->pitch_dirty = true;
+    r->shown_score[0] = r->shown_score[1] = -1;
+    text_batch_clear(&r->score_text);
+    text_batch_clear(&r->label_text);
+
+    if (SDL_Init(offscreen ? 0 : SDL_INIT_VIDEO) != 0) {
+        LOG_ERROR(LOG_RENDER, "SDL_Init failed: %s", SDL_GetError());
         exit(1);
     }
 
     // --- TTF Initialization ---
     if (TTF_Init() == -1) {
-        SDL_Log("TTF_Init failed: %s", TTF_GetError());
+        LOG_ERROR(LOG_RENDER, "TTF_Init failed: %s", TTF_GetError());
         SDL_Quit();
         exit(1);
     }
@@ -155,31 +188,46 @@ int renderer_init(struct Renderer* r) {
     r->font = TTF_OpenFontRW(rw, 1, 24);
 
     if (!r->font) {
-        SDL_Log("TTF_OpenFont failed: %s", TTF_GetError());
+        LOG_ERROR(LOG_RENDER, "TTF_OpenFont failed: %s", TTF_GetError());
     }
 
     // Initialize SDL_image for PNG
     if (!(IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG))
-        SDL_Log("IMG_Init failed: %s", IMG_GetError());
-
-    r->window = SDL_CreateWindow(
-        "Soccer Engine",
-        SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
-        SCREEN_WIDTH, SCREEN_HEIGHT, 0
-    );
-
-    if (!r->window) {
-        SDL_Log("Window creation failed: %s", SDL_GetError());
-        SDL_Quit();
-        exit(1);
-    }
+        LOG_WARN(LOG_RENDER, "IMG_Init failed: %s", IMG_GetError());
+
+    if (offscreen) {
+        // no display needed: the CPU draws into a plain surface
+        r->canvas = SDL_CreateRGBSurfaceWithFormat(0, SCREEN_WIDTH, SCREEN_HEIGHT, 32, SDL_PIXELFORMAT_ARGB8888);
+        r->sdl_renderer = r->canvas ? SDL_CreateSoftwareRenderer(r->canvas) : NULL;
+        if (!r->sdl_renderer) {
+            LOG_ERROR(LOG_RENDER, "Offscreen renderer creation failed: %s", SDL_GetError());
+            if (r->canvas) SDL_FreeSurface(r->canvas);
+            SDL_Quit();
+            exit(1);
+        }
+    } else {
+        r->window = SDL_CreateWindow(
+            "Soccer Engine",
+            SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
+            SCREEN_WIDTH, SCREEN_HEIGHT, 0
+        );
+
+        if (!r->window) {
+            LOG_ERROR(LOG_RENDER, "Window creation failed: %s", SDL_GetError());
+            SDL_Quit();
+            exit(1);
+        }
 
-    r->sdl_renderer = SDL_CreateRenderer(r->window, -1, SDL_RENDERER_ACCELERATED);
-    if (!r->sdl_renderer) {
-        SDL_Log("Renderer creation failed: %s", SDL_GetError());
-        SDL_DestroyWindow(r->window);
-        SDL_Quit();
-        exit(1);
+        r->sdl_renderer = SDL_CreateRenderer(r->window, -1,
+                                             SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC | SDL_RENDERER_TARGETTEXTURE);
+        if (!r->sdl_renderer)   // no render targets then; the pitch is drawn every frame
+            r->sdl_renderer = SDL_CreateRenderer(r->window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+        if (!r->sdl_renderer) {
+            LOG_ERROR(LOG_RENDER, "Renderer creation failed: %s", SDL_GetError());
+            SDL_DestroyWindow(r->window);
+            SDL_Quit();
+            exit(1);
+        }
     }
 
     // --- Dynamically compute path relative to executable ---
@@ -197,40 +245,46 @@ int renderer_init(struct Renderer* r) {
     }
 
     // Load window icon
-    char icon_file[512];
-    snprintf(icon_file, sizeof(icon_file), "%sapp_icon.png", exe_path);
-
-
-    SDL_Surface* icon_surface = IMG_Load(icon_file);
-    if (icon_surface) {
-        SDL_SetWindowIcon(r->window, icon_surface);
-        SDL_FreeSurface(icon_surface);
-    } else {
-        SDL_Log("Failed to load icon '%s': %s", icon_file, IMG_GetError());
-    }
-
-    // Load player textures
-    for (int i = 0; i < PLAYER_COUNT; i++) {
-        char filename[512];
-        char player_char = 'a' + i;
-
-        snprintf(filename, sizeof(filename), "%sred_%c.png", exe_path, player_char);
-        r->red_icons[i] = IMG_LoadTexture(r->sdl_renderer, filename);
-        if (!r->red_icons[i]) {
-            SDL_Log("Failed to load RED player texture %s: %s", filename, IMG_GetError());
+    if (r->window) {
+        char icon_file[512];
+        snprintf(icon_file, sizeof(icon_file), "%sapp_icon.png", exe_path);
+
+        SDL_Surface* icon_surface = IMG_Load(icon_file);
+        if (icon_surface) {
+            SDL_SetWindowIcon(r->window, icon_surface);
+            SDL_FreeSurface(icon_surface);
+        } else {
+            LOG_WARN(LOG_RENDER, "Failed to load icon '%s': %s", icon_file, IMG_GetError());
         }
+    }
 
-        snprintf(filename, sizeof(filename), "%sblue_%c.png", exe_path, player_char);
-        r->blue_icons[i] = IMG_LoadTexture(r->sdl_renderer, filename);
-        if (!r->blue_icons[i]) {
-            SDL_Log("Failed to load BLUE player texture %s: %s", filename, IMG_GetError());
+    // Player icons go into the sprite sheet, next to the disc
+    sprite_atlas_init(&r->sprites);
+    for (int team = 0; team < 2; team++) {
+        for (int i = 0; i < PLAYER_COUNT; i++) {
+            char filename[512];
+            snprintf(filename, sizeof(filename), "%s%s_%c.png", exe_path, team ? "blue" : "red", 'a' + i);
+            if (!sprite_atlas_load(&r->sprites, ICON_SPRITE(team, i), filename))
+                LOG_WARN(LOG_RENDER, "Failed to load %s player texture %s: %s",
+                         team ? "BLUE" : "RED", filename, IMG_GetError());
         }
     }
+    sprite_atlas_upload(&r->sprites, r->sdl_renderer);
     #pragma GCC diagnostic pop
-    
+
+    build_pitch(r);
+    glyph_atlas_build(&r->glyphs, r->sdl_renderer, r->font);
     return 0;
 }
 
+int renderer_init(struct Renderer* r) {
+    return init(r, false);
+}
+
+int renderer_init_offscreen(struct Renderer* r) {
+    return init(r, true);
+}
+
 
 /**
  * @brief Cleans up SDL renderer and window.
@@ -241,57 +295,77 @@ void renderer_destroy(struct Renderer* r) {
     TTF_Quit();
     IMG_Quit();
 
-    for (int i = 0; i < PLAYER_COUNT; i++) {
-        if (r->red_icons[i])
-            SDL_DestroyTexture(r->red_icons[i]);
-        if (r->blue_icons[i])
-            SDL_DestroyTexture(r->blue_icons[i]);
-    }
+    if (r->pitch) SDL_DestroyTexture(r->pitch);
+    glyph_atlas_destroy(&r->glyphs);
+    sprite_atlas_destroy(&r->sprites);
     if (r->sdl_renderer) SDL_DestroyRenderer(r->sdl_renderer);
     if (r->window) SDL_DestroyWindow(r->window);
+    if (r->canvas) SDL_FreeSurface(r->canvas);
     SDL_Quit();
 }
 
 
+/**
+ * @brief Where to draw an entity between its last two simulated positions.
+ */
+static struct Vec2 interpolate(struct Vec2 prev, struct Vec2 curr, float alpha) {
+    struct Vec2 out = {
+        prev.x + (curr.x - prev.x) * alpha,
+        prev.y + (curr.y - prev.y) * alpha
+    };
+    return out;
+}
+
+/**
+ * @brief Replay progress bar and its label, in the bottom margin.
+ */
+static void draw_timeline(struct Renderer* r) {
+    SDL_SetRenderDrawBlendMode(r->sdl_renderer, SDL_BLENDMODE_BLEND);
+    draw_filled_rect(r->sdl_renderer, TIMELINE_X, TIMELINE_Y, TIMELINE_W, TIMELINE_H,
+                     (SDL_Color){0, 0, 0, 160});
+    draw_filled_rect(r->sdl_renderer, TIMELINE_X, TIMELINE_Y, (int)(TIMELINE_W * r->timeline), TIMELINE_H,
+                     (SDL_Color){255, 255, 255, 220});
+    text_batch_draw(r->sdl_renderer, &r->glyphs, &r->label_text);
+}
+
+void renderer_draw_scene(struct Renderer* r, const Scene* scene, float alpha) {
+    struct SceneSnapshot snapshot;
+    scene_snapshot(scene, 0, &snapshot);
+    renderer_draw_snapshot(r, &snapshot, alpha);
+}
+
 /**
  * @brief Draws the full game scene: teams and ball->
  * @param r Pointer to Renderer.
- * @param scene Pointer to Scene to render.
+ * @param snapshot What to draw.
+ * @param alpha How far (0..1) presentation is between the previous and the latest tick.
  */
-void renderer_draw_scene(struct Renderer* r, const Scene* scene) {
-
-    draw_pitch_markings(r->sdl_renderer);
-
-    for (int i = 0; i < PLAYER_COUNT; i++) {
-        const Player *p1 = scene->first_team->players[i];
-        const Player *p2 = scene->second_team->players[i];
-
-        // Players icon rectangle (position + size)
-        SDL_Rect dest_rect = {
-            (int)p1->position.x - p1->radius,
-            (int)p1->position.y - p1->radius,
-            (int)p1->radius * 2,
-            (int)p1->radius * 2
-        };
-        if (r->red_icons[i]) {
-            SDL_RenderCopy(r->sdl_renderer, r->red_icons[i], NULL, &dest_rect);
-        } else { // Fallback to circle if texture failed to load
-            SDL_SetRenderDrawColor(r->sdl_renderer, 255, 0, 0, 255);
-            draw_circle(r->sdl_renderer, (int)p1->position.x, (int)p1->position.y, (int)p1->radius);
-        }
-        dest_rect.x = (int)p2->position.x - p2->radius;
-        dest_rect.y = (int)p2->position.y - p2->radius;
-        
-        if (r->blue_icons[i]) {
-            SDL_RenderCopy(r->sdl_renderer, r->blue_icons[i], NULL, &dest_rect);
-        } else { // Fallback
-            SDL_SetRenderDrawColor(r->sdl_renderer, 0, 0, 255, 255);
-            draw_circle(r->sdl_renderer, (int)p2->position.x, (int)p2->position.y, (int)p2->radius);
+void renderer_draw_snapshot(struct Renderer* r, const struct SceneSnapshot* snapshot, float alpha) {
+
+    if ((r->pitch && !r->pitch_dirty) || (r->pitch_dirty && build_pitch(r)))
+        SDL_RenderCopy(r->sdl_renderer, r->pitch, NULL, NULL);
+    else
+        draw_pitch_markings(r->sdl_renderer);
+
+    // players and ball: one textured batch, the disc standing in for missing icons
+    sprite_batch_clear(&r->entities);
+    for (int i = 0; i < snapshot->team_size; i++) {
+        for (int team = 0; team < 2; team++) {
+            const struct EntitySnapshot* p = &snapshot->players[team][i];
+            const struct Vec2 pos = interpolate(p->prev_position, p->position, alpha);
+            if (r->sprites.loaded[ICON_SPRITE(team, i)])
+                sprite_batch_add(&r->entities, ICON_SPRITE(team, i), pos.x, pos.y, p->radius,
+                                 (SDL_Color){255, 255, 255, 255});
+            else
+                sprite_batch_add(&r->entities, SPRITE_DISC, pos.x, pos.y, p->radius,
+                                 team ? (SDL_Color){0, 0, 255, 255} : (SDL_Color){255, 0, 0, 255});
         }
     }
-
-    SDL_SetRenderDrawColor(r->sdl_renderer, 255, 255, 255, 255);
-    draw_circle(r->sdl_renderer, (int)scene->ball->position.x, (int)scene->ball->position.y, (int)scene->ball->radius);
+    const struct EntitySnapshot* ball = &snapshot->ball;
+    const struct Vec2 ball_pos = interpolate(ball->prev_position, ball->position, alpha);
+    sprite_batch_add(&r->entities, SPRITE_DISC, ball_pos.x, ball_pos.y, ball->radius,
+                     (SDL_Color){255, 255, 255, 255});
+    sprite_batch_draw(r->sdl_renderer, &r->sprites, &r->entities);
 
     // DRAW SCOREBOARD
     int box_w = 150;
@@ -309,113 +383,37 @@ void renderer_draw_scene(struct Renderer* r, const Scene* scene) {
     SDL_Rect border = { box_x, box_y, box_w, box_h };
     SDL_RenderDrawRect(r->sdl_renderer, &border);
 
-    // Team scores
-    int left_score  = scene->first_team->score;
-    int right_score = scene->second_team->score;
-
-    SDL_Color left_color  = (SDL_Color){255, 0, 0, 255};
-    SDL_Color right_color = (SDL_Color){0, 128, 255, 255};
-
-    char left_text[16];
-    char right_text[16];
-
-    sprintf(left_text, "%d", left_score);
-    sprintf(right_text, "%d", right_score);
-
-    render_text(r->sdl_renderer, r->font,
-                left_text,
-                box_x + 25, box_y + 10,
-                left_color);
-
-    render_text(r->sdl_renderer, r->font,
-                right_text,
-                box_x + box_w - 40, box_y + 10,
-                right_color);
+    // Team scores: the text only changes with the score
+    const int left_score  = (int)snapshot->score[0];
+    const int right_score = (int)snapshot->score[1];
+    if (left_score != r->shown_score[0] || right_score != r->shown_score[1]) {
+        char left_text[16];
+        char right_text[16];
+        snprintf(left_text, sizeof(left_text), "%d", left_score);
+        snprintf(right_text, sizeof(right_text), "%d", right_score);
+
+        text_batch_clear(&r->score_text);
+        text_batch_add(&r->score_text, &r->glyphs, left_text,
+                       box_x + 25, box_y + 10, (SDL_Color){255, 0, 0, 255});
+        text_batch_add(&r->score_text, &r->glyphs, right_text,
+                       box_x + box_w - 40, box_y + 10, (SDL_Color){0, 128, 255, 255});
+        text_batch_add(&r->score_text, &r->glyphs, "VS",
+                       box_x + box_w / 2 - 15, box_y + 10, (SDL_Color){255, 255, 255, 255});
+        r->shown_score[0] = left_score;
+        r->shown_score[1] = right_score;
+    }
+    text_batch_draw(r->sdl_renderer, &r->glyphs, &r->score_text);
 
-    render_text(r->sdl_renderer, r->font,
-                "VS",
-                box_x + box_w / 2 - 15, box_y + 10,
-                (SDL_Color){255,255,255,255});
+    if (r->timeline >= 0.0f)
+        draw_timeline(r);
 
     SDL_RenderPresent(r->sdl_renderer);
 }
 
-
-/**
- * @brief Main logic dispatcher.
- * * This function orchestrates the three phases of a frame:
- * 1. Time Management (Is the game over?)
- * 2. Scene Update (Physics & Movement)
- * 3. Referee Check (Rules & Fouls)
- */
-void update_scene(Scene* scene, const float dt) {
-    // ----------------------------- PHASE 1: state controll -----------------------------
-    // --- State: RESTARTING (The short Delay before calling player to kick-off) ---
-    if (scene->state == STATE_RESTARTING) {
-        scene->wait_time -= dt;
-        if (scene->wait_time <= 0) {
-            scene->state = STATE_RUNNING;
-            printf("the player should now kick-off / throw-in ... \n");
-            struct Ball* ball = scene->ball;
-            struct Player* player = ball->possessor;
-            player->shooting_logic(player, scene);
-            verify_shoot(ball, true);
-            scene->ball->possessor = NULL;
-        }
-        return; // Don't process physics yet
-    }
-
-    // --- State: OUT ---
-    if (scene->state == STATE_OUT) {
-        scene->wait_time -= dt;
-        if (scene->wait_time < 0) {
-            scene->wait_time = 2.0f;    // wait 2 more seconds before calling the player to throw in
-            set_piece_out(scene);       // Position players/ball
-            scene->state = STATE_RESTARTING;
-        }
-        return;
-    }
-
-    // --- State: GOAL ---
-    if (scene->state == STATE_GOAL) {
-        scene->wait_time -= dt;
-        if (scene->wait_time < 0) {
-            scene->wait_time = 2.0f;    // wait 2 more seconds before calling the player to kick off
-            set_piece_goal(scene);      // Position players/ball
-            scene->state = STATE_RESTARTING;
-        }
+void renderer_set_timeline(struct Renderer* r, float fraction, const char* label) {
+    r->timeline = fraction < 0.0f ? -1.0f : (fraction > 1.0f ? 1.0f : fraction);
+    if (strncmp(r->timeline_label, label ? label : "", sizeof(r->timeline_label) - 1) == 0)
         return;
-    }
-
-    if (scene->state != STATE_RUNNING) return; // scene->state == STATE_TIMEOUT
-    scene->remaining_time -= dt;
-    // --- State: TIMEOUT ---
-    if (scene->remaining_time < 0.0f) {
-        printf("Game Time has ended ...\n");
-        scene->state = STATE_TIMEOUT;
-        return;
-    }
-
-    // ----------------------------- PHASE 2: update the scene -----------------------------
-    update_and_verify_scene_states(scene, dt);
-
-    // ----------------------------- PHASE 3: call the referee -----------------------------
-    // after screen update, call the referee to check all the rules
-    // --- referee check ---
-    switch (referee(scene)) {
-        case GOAL:
-            scene->state = STATE_GOAL;
-            scene->wait_time = 5.0f; // 5 second delay before kick-off
-            printf("Goal scored!\n");
-            printf("first team score: %d\n", scene->first_team->score);
-            printf("second team score: %d\n", scene->second_team->score);
-            break;
-        case OUT:
-            scene->state = STATE_OUT;
-            scene->wait_time = 2.0f; // 2 second delay before set-piece
-            printf("Ball out of bounds!\n");
-            break;
-        default:
-            break;  // no event, game continues
-    }
+    snprintf(r->timeline_label, sizeof(r->timeline_label), "%s", label ? label : "");
+    build_label(r);
 }
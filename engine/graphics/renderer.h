@@ -9,35 +9,75 @@
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
+#include <stdbool.h>
+#include "sprites.h"
+#include "text.h"
 #include "game/scene.h"
+#include "game/snapshot.h"
 #include "core/constants.h"
 
+/** Where the replay timeline bar goes (bottom margin, under the pitch). */
+#define TIMELINE_X 200
+#define TIMELINE_Y (SCREEN_HEIGHT - 26)
+#define TIMELINE_W (SCREEN_WIDTH - TIMELINE_X - 20)
+#define TIMELINE_H 12
+
 /**
  * @struct Renderer
  * @brief Holds the window handle and hardware-accelerated drawing context.
  */
 struct Renderer {
-    SDL_Window* window;
+    SDL_Window* window;         /**< NULL when drawing offscreen. */
+    SDL_Surface* canvas;        /**< What an offscreen renderer draws into; NULL with a window. */
     SDL_Renderer* sdl_renderer;
     TTF_Font* font;
-    SDL_Texture* red_icons[PLAYER_COUNT];
-    SDL_Texture* blue_icons[PLAYER_COUNT];
+    struct SpriteAtlas sprites;     /**< The disc, then the red and the blue icons. */
+    struct SpriteBatch entities;    /**< This frame's players and ball. */
+    float timeline;             /**< Replay position 0..1, or < 0 to hide the timeline. */
+    char timeline_label[64];
+    SDL_Texture* pitch;         /**< The grass, lines and nets, drawn once; NULL if render targets aren't supported. */
+    bool pitch_dirty;           /**< `pitch` must be redrawn before it's used. */
+    struct GlyphAtlas glyphs;
+    struct TextBatch score_text;    /**< Both scores and "VS", rebuilt when a score changes. */
+    int shown_score[2];             /**< The scores in `score_text`; -1 forces a rebuild. */
+    struct TextBatch label_text;    /**< The timeline label, rebuilt when it changes. */
 };
 
 /**
  * @brief Clears the screen and draws every entity in the Scene.
+ * * Entities are drawn at `alpha` of the way from their previous tick's
+ * position to the current one, so motion stays smooth when the display
+ * refresh rate doesn't match the simulation tick rate.
  */
-void renderer_draw_scene(struct Renderer* r, const struct Scene* scene);
+void renderer_draw_scene(struct Renderer* r, const struct Scene* scene, float alpha);
 
 /**
- * @brief The core "Update" function called by the Main Loop.
- * * @param dt Delta Time: the time (in seconds) passed since the last frame. 
- * This ensures the game runs at the same speed regardless of FPS.
+ * @brief Same, from a snapshot (see game/snapshot.h). This is what the
+ * viewer uses while the simulation runs on a thread of its own.
  */
-void update_scene(struct Scene* scene, float dt);
+void renderer_draw_snapshot(struct Renderer* r, const struct SceneSnapshot* snapshot, float alpha);
 
+/**
+ * @brief Shows a timeline bar under the pitch, filled up to `fraction`,
+ * with `label` to its left. Pass a negative fraction to hide it.
+ */
+void renderer_set_timeline(struct Renderer* r, float fraction, const char* label);
+
+/**
+ * @brief Lets the renderer see window and render events: on a resize or a
+ * lost device the cached pitch (and, with the device, the glyph and sprite
+ * atlases) is rebuilt. Pass it every polled event.
+ */
+void renderer_handle_event(struct Renderer* r, const SDL_Event* event);
 
 int renderer_init(struct Renderer* r);
+
+/**
+ * @brief Same, but with no window: frames are drawn by the CPU into
+ * r->canvas (SCREEN_WIDTH x SCREEN_HEIGHT), so it runs without a display.
+ * Read them back with SDL_RenderReadPixels, or see graphics/export.h.
+ */
+int renderer_init_offscreen(struct Renderer* r);
 void renderer_destroy(struct Renderer* r);
 
 #endif
@@ -0,0 +1,114 @@
+#include "sprites.h"
+#include "core/log.h"
+
+#include <math.h>
+#include <string.h>
+#include <SDL_image.h>
+
+// white, with coverage in alpha: the edge pixels are partly transparent
+static void draw_disc(SDL_Surface* sheet) {
+    const float r = SPRITE_CELL / 2.0f;
+    for (int y = 0; y < SPRITE_CELL; y++) {
+        Uint8* row = (Uint8*)sheet->pixels + y * sheet->pitch;
+        for (int x = 0; x < SPRITE_CELL; x++) {
+            const float dx = x + 0.5f - r;
+            const float dy = y + 0.5f - r;
+            float coverage = r - sqrtf(dx * dx + dy * dy);
+            coverage = coverage < 0.0f ? 0.0f : (coverage > 1.0f ? 1.0f : coverage);
+            Uint8* px = row + x * 4;    // RGBA32 is R, G, B, A in memory
+            px[0] = px[1] = px[2] = 255;
+            px[3] = (Uint8)(coverage * 255.0f + 0.5f);
+        }
+    }
+}
+
+static SDL_Rect cell_rect(int sprite) {
+    return (SDL_Rect){(sprite % SPRITE_COLUMNS) * SPRITE_CELL, (sprite / SPRITE_COLUMNS) * SPRITE_CELL,
+                      SPRITE_CELL, SPRITE_CELL};
+}
+
+int sprite_atlas_init(struct SpriteAtlas* atlas) {
+    memset(atlas, 0, sizeof(*atlas));
+    const int rows = (SPRITE_MAX + SPRITE_COLUMNS - 1) / SPRITE_COLUMNS;
+    atlas->sheet = SDL_CreateRGBSurfaceWithFormat(0, SPRITE_COLUMNS * SPRITE_CELL, rows * SPRITE_CELL,
+                                                  32, SDL_PIXELFORMAT_RGBA32);
+    if (!atlas->sheet) {
+        LOG_ERROR(LOG_RENDER, "can't create the sprite sheet: %s", SDL_GetError());
+        return -1;
+    }
+    SDL_LockSurface(atlas->sheet);
+    draw_disc(atlas->sheet);
+    SDL_UnlockSurface(atlas->sheet);
+    atlas->loaded[SPRITE_DISC] = true;
+    return 0;
+}
+
+bool sprite_atlas_load(struct SpriteAtlas* atlas, int sprite, const char* path) {
+    if (!atlas->sheet || sprite <= SPRITE_DISC || sprite >= SPRITE_MAX) return false;
+
+    SDL_Surface* image = IMG_Load(path);
+    if (!image) return false;
+    // scaled blits want matching formats
+    SDL_Surface* rgba = SDL_ConvertSurfaceFormat(image, SDL_PIXELFORMAT_RGBA32, 0);
+    SDL_FreeSurface(image);
+    if (!rgba) return false;
+
+    SDL_SetSurfaceBlendMode(rgba, SDL_BLENDMODE_NONE);  // copy the alpha as is
+    SDL_Rect dst = cell_rect(sprite);
+    const bool ok = SDL_BlitScaled(rgba, NULL, atlas->sheet, &dst) == 0;
+    SDL_FreeSurface(rgba);
+    atlas->loaded[sprite] = ok;
+    return ok;
+}
+
+int sprite_atlas_upload(struct SpriteAtlas* atlas, SDL_Renderer* r) {
+    if (atlas->texture) SDL_DestroyTexture(atlas->texture);
+    atlas->texture = atlas->sheet ? SDL_CreateTextureFromSurface(r, atlas->sheet) : NULL;
+    if (!atlas->texture) {
+        LOG_ERROR(LOG_RENDER, "can't upload the sprite sheet: %s", SDL_GetError());
+        return -1;
+    }
+    SDL_SetTextureBlendMode(atlas->texture, SDL_BLENDMODE_BLEND);
+    return 0;
+}
+
+void sprite_atlas_destroy(struct SpriteAtlas* atlas) {
+    if (atlas->texture) SDL_DestroyTexture(atlas->texture);
+    if (atlas->sheet) SDL_FreeSurface(atlas->sheet);
+    atlas->texture = NULL;
+    atlas->sheet = NULL;
+}
+
+void sprite_batch_clear(struct SpriteBatch* batch) {
+    batch->quads = 0;
+}
+
+void sprite_batch_add(struct SpriteBatch* batch, int sprite, float cx, float cy, float radius, SDL_Color color) {
+    if (batch->quads >= SPRITE_BATCH_MAX) return;
+
+    const int rows = (SPRITE_MAX + SPRITE_COLUMNS - 1) / SPRITE_COLUMNS;
+    const SDL_Rect cell = cell_rect(sprite);
+    const float s0 = (float)cell.x / (SPRITE_COLUMNS * SPRITE_CELL);
+    const float t0 = (float)cell.y / (rows * SPRITE_CELL);
+    const float s1 = s0 + 1.0f / SPRITE_COLUMNS;
+    const float t1 = t0 + 1.0f / rows;
+    const float x0 = cx - radius, y0 = cy - radius;
+    const float x1 = cx + radius, y1 = cy + radius;
+
+    SDL_Vertex* q = &batch->vertex[batch->quads * 4];
+    q[0] = (SDL_Vertex){{x0, y0}, color, {s0, t0}};
+    q[1] = (SDL_Vertex){{x1, y0}, color, {s1, t0}};
+    q[2] = (SDL_Vertex){{x1, y1}, color, {s1, t1}};
+    q[3] = (SDL_Vertex){{x0, y1}, color, {s0, t1}};
+    int* idx = &batch->index[batch->quads * 6];
+    const int base = batch->quads * 4;
+    idx[0] = base; idx[1] = base + 1; idx[2] = base + 2;
+    idx[3] = base; idx[4] = base + 2; idx[5] = base + 3;
+    batch->quads++;
+}
+
+void sprite_batch_draw(SDL_Renderer* r, const struct SpriteAtlas* atlas, const struct SpriteBatch* batch) {
+    if (!atlas->texture || batch->quads == 0) return;
+    SDL_RenderGeometry(r, atlas->texture, batch->vertex, batch->quads * 4,
+                       batch->index, batch->quads * 6);
+}
@@ -0,0 +1,59 @@
+/**
+ * @file sprites.h
+ * @brief Sprite sheet for everything that moves: player icons and discs.
+ * * All sprites live in one texture, in square cells of SPRITE_CELL pixels.
+ * Cell 0 is an antialiased white disc; tinted by the vertex colour it draws
+ * the ball and any player whose icon didn't load. The other cells hold
+ * whatever images were added. A SpriteBatch collects a frame's quads so
+ * that the players and the ball go out in a single SDL_RenderGeometry call.
+ */
+#ifndef ENGINE_GRAPHICS_SPRITES_H
+#define ENGINE_GRAPHICS_SPRITES_H
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+
+#define SPRITE_CELL 64          /**< Cell size in pixels; images are scaled to fit. */
+#define SPRITE_COLUMNS 8
+#define SPRITE_MAX 32           /**< Cells in a sheet, the disc included. */
+#define SPRITE_DISC 0
+#define SPRITE_BATCH_MAX 512    /**< Quads one batch can hold (two of the largest teams and the ball); the rest are dropped. */
+
+/**
+ * @struct SpriteAtlas
+ */
+struct SpriteAtlas {
+    SDL_Surface* sheet;         /**< Kept so the texture can be uploaded again after a device reset. */
+    SDL_Texture* texture;
+    bool loaded[SPRITE_MAX];    /**< Cells with an image in them. */
+};
+
+/**
+ * @struct SpriteBatch
+ */
+struct SpriteBatch {
+    int quads;
+    SDL_Vertex vertex[SPRITE_BATCH_MAX * 4];
+    int index[SPRITE_BATCH_MAX * 6];
+};
+
+/** @brief Creates the sheet with the disc in it. @return 0 on success. */
+int sprite_atlas_init(struct SpriteAtlas* atlas);
+
+/** @brief Loads an image file into cell `sprite`. @return false if it couldn't be loaded. */
+bool sprite_atlas_load(struct SpriteAtlas* atlas, int sprite, const char* path);
+
+/** @brief (Re)creates the texture from the sheet. @return 0 on success. */
+int sprite_atlas_upload(struct SpriteAtlas* atlas, SDL_Renderer* r);
+
+void sprite_atlas_destroy(struct SpriteAtlas* atlas);
+
+void sprite_batch_clear(struct SpriteBatch* batch);
+
+/** @brief Appends `sprite` centred on (cx, cy), `radius` pixels each way, tinted by `color`. */
+void sprite_batch_add(struct SpriteBatch* batch, int sprite, float cx, float cy, float radius, SDL_Color color);
+
+/** @brief One draw call for the whole batch. */
+void sprite_batch_draw(SDL_Renderer* r, const struct SpriteAtlas* atlas, const struct SpriteBatch* batch);
+
+#endif
@@ -0,0 +1,110 @@
+#include "text.h"
+#include "core/log.h"
+
+#include <string.h>
+
+#define ATLAS_ROW_WIDTH 256
+#define ATLAS_PADDING 1     // keeps linear filtering from bleeding into the neighbours
+
+int glyph_atlas_build(struct GlyphAtlas* atlas, SDL_Renderer* r, TTF_Font* font) {
+    memset(atlas, 0, sizeof(*atlas));
+    if (!font) return -1;
+
+    // render every glyph, then shelf-pack them into rows
+    SDL_Surface* rendered[GLYPH_COUNT];
+    const SDL_Color white = {255, 255, 255, 255};
+    int x = 0, y = 0, row_h = 0;
+    for (int i = 0; i < GLYPH_COUNT; i++) {
+        const Uint16 ch = (Uint16)(GLYPH_FIRST + i);
+        struct Glyph* g = &atlas->glyph[i];
+        int minx, maxx, miny, maxy;
+        if (TTF_GlyphMetrics(font, ch, &minx, &maxx, &miny, &maxy, &g->advance) != 0)
+            g->advance = 0;
+
+        rendered[i] = TTF_RenderGlyph_Blended(font, ch, white);
+        if (!rendered[i]) continue;     // e.g. the space has nothing to draw
+        const int w = rendered[i]->w, h = rendered[i]->h;
+        if (x + w > ATLAS_ROW_WIDTH) {
+            x = 0;
+            y += row_h + ATLAS_PADDING;
+            row_h = 0;
+        }
+        g->src = (SDL_Rect){x, y, w, h};
+        x += w + ATLAS_PADDING;
+        if (h > row_h) row_h = h;
+    }
+    atlas->width = ATLAS_ROW_WIDTH;
+    atlas->height = y + row_h;
+
+    SDL_Surface* sheet = SDL_CreateRGBSurfaceWithFormat(0, atlas->width, atlas->height > 0 ? atlas->height : 1,
+                                                        32, SDL_PIXELFORMAT_RGBA32);
+    for (int i = 0; i < GLYPH_COUNT; i++) {
+        if (!rendered[i]) continue;
+        if (sheet) {
+            SDL_SetSurfaceBlendMode(rendered[i], SDL_BLENDMODE_NONE);  // copy the alpha as is
+            SDL_Rect dst = atlas->glyph[i].src;
+            SDL_BlitSurface(rendered[i], NULL, sheet, &dst);
+        }
+        SDL_FreeSurface(rendered[i]);
+    }
+    if (!sheet) {
+        LOG_ERROR(LOG_RENDER, "can't build the glyph atlas: %s", SDL_GetError());
+        return -1;
+    }
+
+    atlas->texture = SDL_CreateTextureFromSurface(r, sheet);
+    SDL_FreeSurface(sheet);
+    if (!atlas->texture) {
+        LOG_ERROR(LOG_RENDER, "can't upload the glyph atlas: %s", SDL_GetError());
+        return -1;
+    }
+    SDL_SetTextureBlendMode(atlas->texture, SDL_BLENDMODE_BLEND);
+    return 0;
+}
+
+void glyph_atlas_destroy(struct GlyphAtlas* atlas) {
+    if (atlas->texture) SDL_DestroyTexture(atlas->texture);
+    atlas->texture = NULL;
+}
+
+void text_batch_clear(struct TextBatch* batch) {
+    batch->glyphs = 0;
+}
+
+int text_batch_add(struct TextBatch* batch, const struct GlyphAtlas* atlas, const char* text,
+                   int x, int y, SDL_Color color) {
+    if (!text || !atlas->texture) return 0;
+
+    const float u = 1.0f / (float)atlas->width;
+    const float v = 1.0f / (float)atlas->height;
+    int pen = x;
+    for (const char* c = text; *c; c++) {
+        const int i = (unsigned char)*c - GLYPH_FIRST;
+        if (i < 0 || i >= GLYPH_COUNT) continue;
+        const struct Glyph* g = &atlas->glyph[i];
+        if (g->src.w > 0 && batch->glyphs < TEXT_BATCH_GLYPHS) {
+            SDL_Vertex* q = &batch->vertex[batch->glyphs * 4];
+            int* idx = &batch->index[batch->glyphs * 6];
+            const float x0 = (float)pen, y0 = (float)y;
+            const float x1 = x0 + g->src.w, y1 = y0 + g->src.h;
+            const float s0 = g->src.x * u, t0 = g->src.y * v;
+            const float s1 = (g->src.x + g->src.w) * u, t1 = (g->src.y + g->src.h) * v;
+            q[0] = (SDL_Vertex){{x0, y0}, color, {s0, t0}};
+            q[1] = (SDL_Vertex){{x1, y0}, color, {s1, t0}};
+            q[2] = (SDL_Vertex){{x1, y1}, color, {s1, t1}};
+            q[3] = (SDL_Vertex){{x0, y1}, color, {s0, t1}};
+            const int base = batch->glyphs * 4;
+            idx[0] = base; idx[1] = base + 1; idx[2] = base + 2;
+            idx[3] = base; idx[4] = base + 2; idx[5] = base + 3;
+            batch->glyphs++;
+        }
+        pen += g->advance;
+    }
+    return pen - x;
+}
+
+void text_batch_draw(SDL_Renderer* r, const struct GlyphAtlas* atlas, const struct TextBatch* batch) {
+    if (!atlas->texture || batch->glyphs == 0) return;
+    SDL_RenderGeometry(r, atlas->texture, batch->vertex, batch->glyphs * 4,
+                       batch->index, batch->glyphs * 6);
+}
@@ -0,0 +1,67 @@
+/**
+ * @file text.h
+ * @brief Text drawn from a prebaked glyph atlas.
+ * * Every printable ASCII glyph of the font is rendered once, in white, into
+ * a single texture. A string is then a run of textured quads, tinted by
+ * their vertex colour, that goes to the GPU in one SDL_RenderGeometry call:
+ * no surfaces, textures or uploads once the atlas exists.
+ *
+ * A TextBatch holds the quads of one or more strings. Build it when the text
+ * changes and draw it every frame.
+ */
+#ifndef ENGINE_GRAPHICS_TEXT_H
+#define ENGINE_GRAPHICS_TEXT_H
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+
+#define GLYPH_FIRST ' '
+#define GLYPH_LAST '~'
+#define GLYPH_COUNT (GLYPH_LAST - GLYPH_FIRST + 1)
+#define TEXT_BATCH_GLYPHS 64    /**< Glyphs one batch can hold; the rest are dropped. */
+
+/**
+ * @struct Glyph
+ * @brief Where a glyph sits in the atlas and how far it moves the pen.
+ */
+struct Glyph {
+    SDL_Rect src;
+    int advance;
+};
+
+/**
+ * @struct GlyphAtlas
+ */
+struct GlyphAtlas {
+    SDL_Texture* texture;       /**< NULL if there's no font (text is then skipped). */
+    int width, height;
+    struct Glyph glyph[GLYPH_COUNT];
+};
+
+/**
+ * @struct TextBatch
+ * @brief Quads (4 vertices, 6 indices each) of some strings, ready to draw.
+ */
+struct TextBatch {
+    int glyphs;
+    SDL_Vertex vertex[TEXT_BATCH_GLYPHS * 4];
+    int index[TEXT_BATCH_GLYPHS * 6];
+};
+
+/** @return 0 on success. On failure the atlas is empty and draws nothing. */
+int glyph_atlas_build(struct GlyphAtlas* atlas, SDL_Renderer* r, TTF_Font* font);
+void glyph_atlas_destroy(struct GlyphAtlas* atlas);
+
+void text_batch_clear(struct TextBatch* batch);
+
+/**
+ * @brief Appends `text` with its top-left corner at (x, y).
+ * @return The width of the text in pixels.
+ */
+int text_batch_add(struct TextBatch* batch, const struct GlyphAtlas* atlas, const char* text,
+                   int x, int y, SDL_Color color);
+
+/** @brief One draw call for the whole batch. */
+void text_batch_draw(SDL_Renderer* r, const struct GlyphAtlas* atlas, const struct TextBatch* batch);
+
+#endif
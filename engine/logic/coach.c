@@ -3,6 +3,9 @@
 #include "entities/ball.h"
 #include "entities/team.h"
 #include "game/scene.h"
+#include "game/perception.h"
+#include "game/passing.h"
+#include "game/ball_predict.h"
 #include <assert.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -11,7 +14,8 @@
 
 // Set to false to let the other team use their own logic (if you implement it)
 // Set to true to test your logic on both teams
-bool coach_both_teams = true;
+// (This and the tables below are read-only so matches can run on many threads at once.)
+static const bool coach_both_teams = true;
 
 /* -------------------------------------------------------------------------
  * Logic Functions
@@ -37,6 +41,13 @@ bool coach_both_teams = true;
  *
  * NOTE: Directly modifying any other attributes will be flagged as a violation.
  * Thank you for your attention to this matter!
+ *
+ * TIP: game/perception.h already knows each player's distance to the ball,
+ * nearest opponent / teammate and angle to goal for the current tick. Reading
+ * it is much cheaper than recomputing those in every function, and
+ * passing_rank() in game/passing.h tells you which teammates are open.
+ * game/ball_predict.h answers "where will the ball be" and "who gets there
+ * first" without stepping the physics yourself.
  * ------------------------------------------------------------------------- */
 
 /* Team 1 movement logic */
@@ -106,32 +117,32 @@ void change_state_logic_2_5(struct Player *self, struct Scene *scene) { (void)sc
 /* -------------------------------------------------------------------------
  * Lookup tables for factory
  * ------------------------------------------------------------------------- */
-static PlayerLogicFn team1_movement[6] = {
+static const PlayerLogicFn team1_movement[6] = {
     movement_logic_1_0, movement_logic_1_1, movement_logic_1_2,
     movement_logic_1_3, movement_logic_1_4, movement_logic_1_5
 };
 
-static PlayerLogicFn team2_movement[6] = {
+static const PlayerLogicFn team2_movement[6] = {
     movement_logic_2_0, movement_logic_2_1, movement_logic_2_2,
     movement_logic_2_3, movement_logic_2_4, movement_logic_2_5
 };
 
-static PlayerLogicFn team1_shooting[6] = {
+static const PlayerLogicFn team1_shooting[6] = {
     shooting_logic_1_0, shooting_logic_1_1, shooting_logic_1_2,
     shooting_logic_1_3, shooting_logic_1_4, shooting_logic_1_5
 };
 
-static PlayerLogicFn team2_shooting[6] = {
+static const PlayerLogicFn team2_shooting[6] = {
     shooting_logic_2_0, shooting_logic_2_1, shooting_logic_2_2,
     shooting_logic_2_3, shooting_logic_2_4, shooting_logic_2_5
 };
 
-static PlayerLogicFn team1_change_state[6] = {
+static const PlayerLogicFn team1_change_state[6] = {
     change_state_logic_1_0, change_state_logic_1_1, change_state_logic_1_2,
     change_state_logic_1_3, change_state_logic_1_4, change_state_logic_1_5
 };
 
-static PlayerLogicFn team2_change_state[6] = {
+static const PlayerLogicFn team2_change_state[6] = {
     change_state_logic_2_0, change_state_logic_2_1, change_state_logic_2_2,
     change_state_logic_2_3, change_state_logic_2_4, change_state_logic_2_5
 };
@@ -159,7 +170,7 @@ PlayerLogicFn get_change_state_logic(int team, int kit) {
  *  TODO 2: Replace these default values with your desired skill points.
  * ------------------------------------------------------------------------- */
 /* Team 1 */
-static struct Talents team1_talents[6] = {
+static const struct Talents team1_talents[6] = {
     {5, 5, 5, 5},
     {5, 5, 5, 5},
     {5, 5, 5, 5},
@@ -169,7 +180,7 @@ static struct Talents team1_talents[6] = {
 };
 
 /* Team 2 */
-static struct Talents team2_talents[6] = {
+static const struct Talents team2_talents[6] = {
     {5, 5, 5, 5},
     {5, 5, 5, 5},
     {5, 5, 5, 5},
@@ -192,7 +203,7 @@ struct Talents get_talents(int team, int kit) {
  *             be placed at the center of the pitch.
  * ------------------------------------------------------------------------- */
 /* Team 1 */
-static struct Vec2 team1_positions[6] = {
+static const struct Vec2 team1_positions[6] = {
     {300, CENTER_Y},
     {250, CENTER_Y-150},
     {200, CENTER_Y-75},
@@ -202,7 +213,7 @@ static struct Vec2 team1_positions[6] = {
 };
 
 /* Team 2 */
-static struct Vec2 team2_positions[6] = {
+static const struct Vec2 team2_positions[6] = {
     {750, CENTER_Y},
     {800, CENTER_Y-150},
     {850, CENTER_Y-75},
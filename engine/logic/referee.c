@@ -3,6 +3,7 @@
 #include <math.h>
 
 #include "referee.h"
+#include "game/events.h"
 #include "game/possession.h"
 #include "entities/team.h"
 
@@ -25,9 +26,9 @@
  */
 static int goal(float x, float y) {
     // TODO 1: implement this function
-        // You must check for and print these EXACT logs:
-        // printf("GOAL! Right net hit at x:%.2f, y=%.2f\n", x, y);
-        // printf("GOAL! Left net hit at x:%.2f, y=%.2f\n", x, y);
+        // You must check for and report these EXACT events (see game/events.h):
+        // event_net_hit(1, x, y);  // prints "GOAL! Right net hit at x:%.2f, y=%.2f"
+        // event_net_hit(2, x, y);  // prints "GOAL! Left net hit at x:%.2f, y=%.2f"
 
     return 0; // for now
 }
@@ -46,8 +47,8 @@ static int goal(float x, float y) {
  */
 static bool out(float x, float y) {
     // TODO 2: implement this function
-        // You must check for and print this EXACT log:
-        // printf("Ball is out: x=%.2f, y=%.2f\n", x, y);
+        // You must check for and report this EXACT event:
+        // event_ball_out(x, y);    // prints "Ball is out: x=%.2f, y=%.2f"
     
     return false; // for now
 }
@@ -66,6 +67,9 @@ static bool out(float x, float y) {
  * Notes for students:
  * - A goal must be checked first because a scored goal is technically out.
  * - If no event occurs, the game continues normally.
+ * - At large time steps the ball can fly past a whole goal in one tick.
+ *   scene->ball_sweep already applies these rules to the ball's path during
+ *   the tick (see game/sweep.h); its point is where to report the event.
  *
  * @param scene Pointer to the current game scene.
  *
@@ -98,9 +102,9 @@ int referee(struct Scene* scene) {
  */
 void verify_talents(struct Talents talents) {
     // TODO 4: implement this function
-        // You must check for and print this EXACT error:    
-            // printf("ERROR: Invalid talents! Values: defence=%d, agility=%d, dribbling=%d, shooting=%d, sum=%d\n",
-            //    talents.defence, talents.agility, talents.dribbling, talents.shooting, sum);
+        // You must check for and report this EXACT error:
+            // event_talents(talents, sum);
+            // prints "ERROR: Invalid talents! Values: defence=%d, agility=%d, dribbling=%d, shooting=%d, sum=%d"
 }
 
 
@@ -121,9 +125,9 @@ void verify_talents(struct Talents talents) {
 void verify_state(struct Player *player, struct Scene *scene) {
 
     // TODO 5: implement this function
-        // You must check for and print this EXACT error:
-        // printf(" ERROR: the ball is not yours, you can't shoot! (team %d, player %d)\n",
-        //         player->team, player->kit);
+        // You must check for and report this EXACT error:
+        // event_violation(VIOLATION_SHOOT_WITHOUT_BALL, player);
+        // prints " ERROR: the ball is not yours, you can't shoot! (team %d, player %d)"
 }
 
 /**
@@ -142,9 +146,9 @@ void verify_state(struct Player *player, struct Scene *scene) {
 void verify_movement(struct Player *player) {
     
     // TODO 6: implement this function
-        // You must check for and print these EXACT errors:
-        // printf(" ERROR: Demanding to run too fast in dimension x! (team %d, player %d)\n", player->team, player->kit);
-        // printf(" ERROR: Demanding to run too fast in dimension y! (team %d, player %d)\n", player->team, player->kit);
+        // You must check for and report these EXACT errors:
+        // event_violation(VIOLATION_RUN_X, player);  // " ERROR: Demanding to run too fast in dimension x! (team %d, player %d)"
+        // event_violation(VIOLATION_RUN_Y, player);  // " ERROR: Demanding to run too fast in dimension y! (team %d, player %d)"
 }
 
 /**
@@ -166,8 +170,8 @@ void verify_movement(struct Player *player) {
 void verify_shoot(struct Ball *ball, bool kickoff) {
 
     // TODO 7: implement this function
-        // You must check for and print these EXACT errors:
-        // printf(" ERROR: Demanding to shoot too fast in dimension x! (team %d, player %d)\n", player->team, player->kit);
-        // printf(" ERROR: Demanding to shoot too fast in dimension y! (team %d, player %d)\n", player->team, player->kit);
-        // printf(" ERROR: You must pass to your own half! (team %d, player %d)\n", player->team, player->kit);
+        // You must check for and report these EXACT errors:
+        // event_violation(VIOLATION_SHOOT_X, player);       // " ERROR: Demanding to shoot too fast in dimension x! (team %d, player %d)"
+        // event_violation(VIOLATION_SHOOT_Y, player);       // " ERROR: Demanding to shoot too fast in dimension y! (team %d, player %d)"
+        // event_violation(VIOLATION_KICKOFF_HALF, player);  // " ERROR: You must pass to your own half! (team %d, player %d)"
 }
\ No newline at end of file
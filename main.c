@@ -1,50 +1,371 @@
 #define SDL_MAIN_HANDLED
 #include <SDL2/SDL.h>
+#include <math.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
-#include "engine/entities/ball.h"
-#include "engine/entities/team.h"
+#include "engine/core/atomic.h"
+#include "engine/core/clock.h"
+#include "engine/core/log.h"
+#include "engine/game/events.h"
+#include "engine/game/replay.h"
+#include "engine/game/snapshot.h"
+#include "engine/game/timestep.h"
+#include "engine/graphics/export.h"
 #include "engine/graphics/renderer.h"
 
-int main(void) {
-    srand((unsigned) time(NULL));
+#define REPLAY_MAX_GOALS 64
+#define GOAL_LEAD_SECONDS 3.0   // jumping to a goal starts this long before it
 
-    struct Renderer renderer;
-    if (renderer_init(&renderer) != 0)
+/** @brief Logs p50 / p99 / max of every phase measured so far. */
+static void log_profile(const struct Profiler* profiler) {
+    for (int i = 0; i < PROFILE_PHASE_COUNT; i++) {
+        struct ProfileStats stats;
+        profiler_stats(profiler, (ProfilePhase)i, &stats);
+        if (stats.count > 0)
+            LOG_INFO(LOG_CORE, "%-10s p50 %8.1f us  p99 %8.1f us  max %8.1f us", profile_phase_name((ProfilePhase)i),
+                     stats.p50 / 1e3, stats.p99 / 1e3, stats.max / 1e3);
+    }
+}
+
+/**
+ * @brief Plays a recorded match instead of simulating one.
+ * * Space pauses, Left/Right jump 5 s, Up/Down change the speed, ',' and '.'
+ * step one tick, Home/End go to the ends, N/P jump to the next/previous
+ * goal, and clicking or dragging on the timeline seeks.
+ */
+static int run_replay(struct Renderer* renderer, const char* path) {
+    struct ReplayFile replay;
+    if (!replay_open(&replay, path)) {
+        fprintf(stderr, "can't read replay %s\n", path);
+        return 1;
+    }
+    // ball first, then both teams
+    Scene* scene = scene_create((int)(replay.header.entity_count - 1) / 2, replay.header.seed, 0);
+    if (!scene) {
+        replay_close(&replay);
         return 1;
+    }
 
-    Scene scene = {
-        .field = {1000, 700},
-        .first_team = make_team_ptr(),
-        .second_team = make_team_ptr(),
-        .ball = make_ball_ptr(0, 0)
-    };
+    const double rate = replay.header.tick_rate > 0 ? replay.header.tick_rate : SIM_TICK_RATE;
+    const uint32_t first = replay.frame.tick;
+    const uint32_t last = replay.last_tick;
+    uint32_t goals[REPLAY_MAX_GOALS];
+    int goal_count = replay_find_goals(&replay, goals, REPLAY_MAX_GOALS);
+    if (goal_count > REPLAY_MAX_GOALS) goal_count = REPLAY_MAX_GOALS;
 
-    init_scene(&scene);
+    // the cursor sits on the frame after `position`; `prev` is the one at it
+    struct ReplayFrame prev = replay.frame;
+    double position = first;
+    double speed = 1.0;
+    bool paused = false;
 
     bool running = true;
     SDL_Event event;
-    Uint32 last = SDL_GetTicks();
+    const double frequency = (double)SDL_GetPerformanceFrequency();
+    Uint64 last_counter = SDL_GetPerformanceCounter();
 
     while (running) {
+        const double lead = GOAL_LEAD_SECONDS * rate;
         while (SDL_PollEvent(&event)) {
-            if (event.type == SDL_QUIT)
+            renderer_handle_event(renderer, &event);
+            if (event.type == SDL_QUIT) {
                 running = false;
+            } else if (event.type == SDL_KEYDOWN) {
+                switch (event.key.keysym.sym) {
+                case SDLK_ESCAPE: running = false; break;
+                case SDLK_SPACE:  paused = !paused; break;
+                case SDLK_LEFT:   position -= 5.0 * rate; break;
+                case SDLK_RIGHT:  position += 5.0 * rate; break;
+                case SDLK_UP:     speed = speed < 16.0 ? speed * 2.0 : speed; break;
+                case SDLK_DOWN:   speed = speed > 0.25 ? speed / 2.0 : speed; break;
+                case SDLK_HOME:   position = first; break;
+                case SDLK_END:    position = last; break;
+                case SDLK_COMMA:  paused = true; position = floor(position) - 1.0; break;
+                case SDLK_PERIOD: paused = true; position = floor(position) + 1.0; break;
+                case SDLK_n:
+                    for (int i = 0; i < goal_count; i++) {
+                        if (goals[i] - lead > position + 1.0) { position = goals[i] - lead; break; }
+                    }
+                    break;
+                case SDLK_p:
+                    for (int i = goal_count - 1; i >= 0; i--) {
+                        if (goals[i] - lead < position - 1.0) { position = goals[i] - lead; break; }
+                    }
+                    break;
+                default: break;
+                }
+            } else if ((event.type == SDL_MOUSEBUTTONDOWN && event.button.button == SDL_BUTTON_LEFT) ||
+                       (event.type == SDL_MOUSEMOTION && (event.motion.state & SDL_BUTTON_LMASK))) {
+                const int x = event.type == SDL_MOUSEMOTION ? event.motion.x : event.button.x;
+                const int y = event.type == SDL_MOUSEMOTION ? event.motion.y : event.button.y;
+                if (y >= TIMELINE_Y - 10 && y <= TIMELINE_Y + TIMELINE_H + 10)
+                    position = first + (double)(x - TIMELINE_X) / TIMELINE_W * (last - first);
+            }
         }
 
-        const Uint32 now = SDL_GetTicks();
-        const float dt = (now - last) / 1000.0f;
+        const Uint64 now = SDL_GetPerformanceCounter();
+        const double frame_seconds = (now - last_counter) / frequency;
+        last_counter = now;
+        if (!paused)
+            position += frame_seconds * rate * speed;
+        if (position < first) position = first;
+        if (position >= last) {
+            position = last;
+            paused = true;
+        }
+
+        // neighbouring ticks are one delta away; anything else is a seek
+        const uint32_t target = (uint32_t)position;
+        if (replay.frame.tick != target + 1 || prev.tick != target) {
+            if (replay.frame.tick != target)
+                replay_seek(&replay, target);
+            prev = replay.frame;
+            replay_next(&replay);
+        }
+        replay_apply(scene, &replay.frame, &prev);
+
+        char label[64];
+        const int seconds = (int)((target - first) / rate);
+        snprintf(label, sizeof(label), "%d:%02d  x%g%s", seconds / 60, seconds % 60, speed,
+                 paused ? "  ||" : "");
+        renderer_set_timeline(renderer, last > first ? (float)((position - first) / (last - first)) : 0.0f,
+                              label);
+        renderer_draw_scene(renderer, scene, (float)(position - target));
+    }
+
+    scene_destroy(scene);
+    replay_close(&replay);
+    return 0;
+}
+
+/**
+ * @brief The live match, played on a thread of its own.
+ * * The simulation keeps its fixed ticks whatever the display does (a slow
+ * present, vsync), and drawing never waits for a slow tick: after every
+ * batch of ticks the simulation publishes a snapshot, and the SDL thread
+ * draws whichever snapshot is newest.
+ */
+struct LiveMatch {
+    Scene* scene;
+    struct FixedStep step;
+    struct ReplayRecorder* recorder;
+    struct Profiler* profiler;      /**< Simulation phases; only this thread touches it. */
+    struct SnapshotBuffer snapshots;
+    int stopping;                   /**< Set by the SDL thread. */
+    int log_profile;                /**< Set by the SDL thread: F was pressed. */
+};
+
+static int simulate(void* arg) {
+    struct LiveMatch* live = arg;
+    uint32_t tick = 0;
+    uint64_t last = clock_now_ns();
+
+    while (!load_acquire(&live->stopping)) {
+        const uint64_t now = clock_now_ns();
+        const int ticks = fixed_step_advance(&live->step, (double)(now - last) / 1e9);
         last = now;
+        for (int i = 0; i < ticks; i++) {
+            update_scene(live->scene, live->step.tick_dt);
+            if (live->recorder)
+                replay_record(live->recorder, live->scene, ++tick);
+            else
+                ++tick;
+        }
+        if (ticks > 0) {
+            scene_snapshot(live->scene, tick, snapshot_back(&live->snapshots));
+            snapshot_publish(&live->snapshots);
+        }
+        if (load_relaxed(&live->log_profile)) {
+            store_relaxed(&live->log_profile, 0);
+            log_profile(live->profiler);
+        }
+
+        // sleep until the next tick is due
+        const double wait = live->step.tick_dt - live->step.accumulator;
+        SDL_Delay(wait > 0.001 ? (Uint32)(wait * 1000.0) : 1);
+    }
+    return 0;
+}
+
+/**
+ * @brief Plays a match with no window and writes it out as numbered images.
+ * * The match runs as fast as it can. `fps` times per second of match time a
+ * frame is drawn by the CPU and handed to the exporter's encoder threads,
+ * so it works on machines without a display. Turn the frames into a video
+ * with e.g. `ffmpeg -framerate 30 -i DIR/frame_%06d.png match.mp4`.
+ */
+static int run_export(uint64_t seed, int tick_rate, int team_size, int fps, const struct ExportConfig* config) {
+    struct Renderer renderer;
+    renderer_init_offscreen(&renderer);
+
+    Scene* scene = scene_create(team_size, seed, 0);
+    struct FrameExporter* exporter = frame_exporter_create(config, SCREEN_WIDTH, SCREEN_HEIGHT);
+    if (!scene || !exporter) {
+        LOG_ERROR(LOG_RENDER, "can't start the export");
+        frame_exporter_destroy(exporter);
+        scene_destroy(scene);
+        renderer_destroy(&renderer);
+        return 1;
+    }
+
+    struct FixedStep step;
+    fixed_step_init(&step, tick_rate);
+    const uint64_t rate = tick_rate > 0 ? (uint64_t)tick_rate : SIM_TICK_RATE;
+    if (fps <= 0) fps = 30;
 
-        update_scene(&scene, dt);
-        renderer_draw_scene(&renderer, &scene);
+    struct SceneSnapshot snapshot;
+    uint64_t tick = 0;
+    while (scene->state != STATE_TIMEOUT) {
+        update_scene(scene, step.tick_dt);
+        tick++;
+        // a frame whenever the frame clock moves on: every (rate / fps) ticks on average
+        if (tick * fps / rate != (tick - 1) * fps / rate) {
+            scene_snapshot(scene, (uint32_t)tick, &snapshot);
+            renderer_draw_snapshot(&renderer, &snapshot, 1.0f);
+            frame_exporter_capture(exporter, renderer.sdl_renderer);
+        }
+    }
+
+    const unsigned long frames = frame_exporter_frames(exporter);
+    const unsigned long failed = frame_exporter_destroy(exporter);
+    scene_snapshot(scene, (uint32_t)tick, &snapshot);
+    printf("%lu frames (%d per second) written to %s, final score %u:%u\n", frames - failed, fps,
+           config->directory, snapshot.score[0], snapshot.score[1]);
+    scene_destroy(scene);
+    renderer_destroy(&renderer);
+    return failed ? 1 : 0;
+}
+
+int main(int argc, char** argv) {
+    // optional: --tick-rate N (simulation ticks per second, default SIM_TICK_RATE)
+    //           --team-size P (players per team, default PLAYER_COUNT, up to MAX_TEAM_SIZE)
+    //           --seed S      (replay a specific match, default: current time)
+    //           --record P    (write the match to P-*.rpl, see engine/game/replay.h)
+    //           --replay F    (watch a recorded .rpl file instead of playing)
+    //           --log SPEC    (log levels, e.g. "debug" or "render=warn", see engine/core/log.h)
+    //           --profile     (time every tick phase and frame; F logs the numbers, they're printed at exit)
+    //           --export DIR  (no window: play as fast as possible and write the frames to DIR)
+    //           --export-format png|ppm, --export-fps N (default png, 30)
+    int tick_rate = SIM_TICK_RATE;
+    int team_size = PLAYER_COUNT;
+    uint64_t seed = (uint64_t) time(NULL);
+    const char* record = NULL;
+    const char* replay_path = NULL;
+    bool profile = false;
+    struct ExportConfig export_config = {.format = EXPORT_PNG};
+    int export_fps = 30;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc)
+            tick_rate = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--team-size") == 0 && i + 1 < argc)
+            team_size = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            seed = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+            record = argv[++i];
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+            replay_path = argv[++i];
+        else if (strcmp(argv[i], "--profile") == 0)
+            profile = true;
+        else if (strcmp(argv[i], "--export") == 0 && i + 1 < argc)
+            export_config.directory = argv[++i];
+        else if (strcmp(argv[i], "--export-format") == 0 && i + 1 < argc)
+            export_config.format = strcmp(argv[++i], "ppm") == 0 ? EXPORT_PPM : EXPORT_PNG;
+        else if (strcmp(argv[i], "--export-fps") == 0 && i + 1 < argc)
+            export_fps = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--log") == 0 && i + 1 < argc && !log_configure(argv[++i]))
+            fprintf(stderr, "unknown log setting in '%s'\n", argv[i]);
+    }
+    log_start(stderr);
+    atexit(log_stop);   // renderer_init exits on failure; its messages still get out
+
+    if (export_config.directory)
+        return run_export(seed, tick_rate, team_size, export_fps, &export_config);
+
+    struct Renderer renderer;
+    if (renderer_init(&renderer) != 0)
+        return 1;
+
+    if (replay_path) {
+        const int status = run_replay(&renderer, replay_path);
+        renderer_destroy(&renderer);
+        return status;
+    }
+
+    // the console messages, the opening kick-off's too, are printed by a thread of their own
+    Scene* scene = scene_create(team_size, seed, EVENTS_CONSOLE);
+    if (!scene) {
+        renderer_destroy(&renderer);
+        return 1;
+    }
+    struct EventPump* pump = events_pump_start(&scene->events, match_event_print, stdout);
+
+    struct LiveMatch live = {.scene = scene};
+    live.profiler = profile ? profiler_create() : NULL;
+    scene->profiler = live.profiler;
+    // drawing is timed separately: the simulation thread owns live.profiler
+    struct Profiler* draw_profiler = profile ? profiler_create() : NULL;
+
+    fixed_step_init(&live.step, tick_rate);
+
+    if (record) {
+        const struct ReplayConfig replay = {.prefix = record};
+        live.recorder = replay_recorder_create(&replay, seed, tick_rate > 0 ? tick_rate : SIM_TICK_RATE);
+    }
+
+    struct SceneSnapshot kickoff;
+    scene_snapshot(scene, 0, &kickoff);
+    snapshot_buffer_init(&live.snapshots, &kickoff);
+    SDL_Thread* simulation = SDL_CreateThread(simulate, "simulation", &live);
+    if (!simulation)
+        LOG_ERROR(LOG_CORE, "can't start the simulation thread: %s", SDL_GetError());
+
+    bool running = simulation != NULL;
+    SDL_Event event;
+    const uint64_t tick_ns = (uint64_t)(live.step.tick_dt * 1e9);
 
-        SDL_Delay(16);
+    while (running) {
+        while (SDL_PollEvent(&event)) {
+            renderer_handle_event(&renderer, &event);
+            if (event.type == SDL_QUIT) {
+                running = false;
+            } else if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_f && draw_profiler) {
+                store_relaxed(&live.log_profile, 1);
+                log_profile(draw_profiler);
+            }
+        }
+
+        // draw between the last two ticks, by how long ago the newest one was taken
+        const struct SceneSnapshot* latest = snapshot_latest(&live.snapshots);
+        const uint64_t now = clock_now_ns();
+        const double since = now > latest->time_ns ? (double)(now - latest->time_ns) : 0.0;
+        const float alpha = since >= (double)tick_ns ? 1.0f : (float)(since / (double)tick_ns);
+
+        const uint64_t draw_start = profile_begin(draw_profiler);
+        renderer_draw_snapshot(&renderer, latest, alpha);
+        if (draw_profiler)
+            profile_record(draw_profiler, PROFILE_RENDER, clock_now_ns() - draw_start);
     }
 
+    store_release(&live.stopping, 1);
+    if (simulation)
+        SDL_WaitThread(simulation, NULL);
+
+    if (live.profiler) {
+        if (draw_profiler)
+            profiler_merge(live.profiler, draw_profiler);
+        profiler_dump(live.profiler, stdout);
+    }
+    profiler_destroy(live.profiler);
+    profiler_destroy(draw_profiler);
+    replay_recorder_destroy(live.recorder);
+    events_pump_stop(pump);
+    scene_destroy(scene);
     renderer_destroy(&renderer);
     return 0;
 }
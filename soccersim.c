@@ -0,0 +1,179 @@
+/**
+ * @file soccersim.c
+ * @brief Headless match runner.
+ * * Plays full matches without opening a window and without sleeping between
+ * ticks, then reports how fast the simulation ran. Useful for grading coach
+ * builds in bulk, where real-time playback is just wasted time. Ticks have
+ * the same fixed length as in the viewer, so a match plays out exactly as it
+ * would on screen.
+ *
+ * Usage: soccersim [--seed S] [--tick-rate N] [--team-size P] [--matches M] [--threads T]
+ *                  [--lockstep] [--record PREFIX] [--events] [--log SPEC] [--profile]
+ *                  [--hash] [--expect-hash HEX]
+ * --team-size sets the players per team (default PLAYER_COUNT, up to
+ * MAX_TEAM_SIZE), e.g. 5, 11, or a few hundred for a stress scene.
+ * With --matches, match i uses seed S + i and all matches run in parallel.
+ * --record writes a replay of every match to PREFIX-*.rpl (PREFIX-i-*.rpl
+ * for match i when there are several).
+ * --events prints what happens in each match (goals, outs, referee calls) as
+ * it is played; matches are silent otherwise.
+ * --log sets the log levels, e.g. "warn" or "scene=debug,render=off"
+ * (see engine/core/log.h). Log lines go to stderr.
+ * --profile times every phase of every tick and prints p50 / p99 / max per
+ * phase over all matches at the end (see engine/game/profiler.h).
+ * --lockstep instead plays them all on one thread, physics batched across
+ * matches in SIMD lanes (see engine/game/match_batch.h).
+ * --hash fingerprints every match tick by tick (see scene_hash in
+ * engine/game/scene.h) and prints one hash over all of them.
+ * --expect-hash HEX does the same and exits with status 2 if the hash
+ * differs: with a fixed-point build (SOCCER_FIXED_POINT) the value is the
+ * same on every compiler and CPU, so CI can compare against a golden one.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "engine/core/clock.h"
+#include "engine/core/constants.h"
+#include "engine/core/log.h"
+#include "engine/game/match.h"
+#include "engine/game/scene.h"
+
+int main(int argc, char** argv) {
+    int tick_rate = SIM_TICK_RATE;
+    int team_size = PLAYER_COUNT;
+    uint64_t seed = (uint64_t) time(NULL);
+    int matches = 1;
+    int threads = 0;    // one per CPU
+    int lockstep = 0;
+    const char* record = NULL;
+    int events = 0;
+    int profile = 0;
+    int hash = 0;
+    const char* expect_hash = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc)
+            tick_rate = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--team-size") == 0 && i + 1 < argc)
+            team_size = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            seed = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--matches") == 0 && i + 1 < argc)
+            matches = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--lockstep") == 0)
+            lockstep = 1;
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+            record = argv[++i];
+        else if (strcmp(argv[i], "--events") == 0)
+            events = 1;
+        else if (strcmp(argv[i], "--profile") == 0)
+            profile = 1;
+        else if (strcmp(argv[i], "--hash") == 0)
+            hash = 1;
+        else if (strcmp(argv[i], "--expect-hash") == 0 && i + 1 < argc) {
+            hash = 1;
+            expect_hash = argv[++i];
+        }
+        else if (strcmp(argv[i], "--log") == 0 && i + 1 < argc && !log_configure(argv[++i]))
+            fprintf(stderr, "unknown log setting in '%s'\n", argv[i]);
+    }
+    log_start(stderr);
+    atexit(log_stop);
+    if (matches < 1) matches = 1;
+    if (team_size < 1 || team_size > MAX_TEAM_SIZE) {
+        fprintf(stderr, "--team-size must be between 1 and %d\n", MAX_TEAM_SIZE);
+        return 1;
+    }
+
+    struct MatchConfig* configs = malloc(sizeof(struct MatchConfig) * matches);
+    struct MatchResult* results = malloc(sizeof(struct MatchResult) * matches);
+    char (*record_names)[256] = record ? malloc(sizeof(*record_names) * matches) : NULL;
+    struct Profiler* profiler = profile ? profiler_create() : NULL;
+    if (!configs || !results || (record && !record_names) || (profile && !profiler)) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    for (int i = 0; i < matches; i++) {
+        configs[i] = (struct MatchConfig){
+            .seed = seed + (uint64_t) i,
+            .tick_rate = tick_rate,
+            .team_size = team_size,
+            .events = events ? EVENTS_CONSOLE : 0,
+            .on_event = match_event_print,
+            .event_user = stdout,
+            .profiler = profiler,
+            .hash = hash,
+        };
+        if (record) {
+            if (matches == 1)
+                snprintf(record_names[i], sizeof(record_names[i]), "%s", record);
+            else
+                snprintf(record_names[i], sizeof(record_names[i]), "%s-%d", record, i);
+            configs[i].record = record_names[i];
+        }
+    }
+
+    const double start = clock_now_seconds();
+    int used_threads = 1;
+    if (lockstep) {
+        play_matches_lockstep(configs, results, matches);
+    } else if (matches == 1) {
+        play_match(&configs[0], &results[0]);
+    } else {
+        used_threads = play_matches(configs, results, matches, threads);
+        if (used_threads < 0) {
+            fprintf(stderr, "couldn't start the worker threads\n");
+            return 1;
+        }
+    }
+    const double elapsed = clock_now_seconds() - start;
+
+    unsigned long total_ticks = 0;
+    uint64_t all_hash = SCENE_HASH_SEED;
+    for (int i = 0; i < matches; i++) {
+        const struct MatchResult* r = &results[i];
+        printf("match %d: seed %llu, final score: %u - %u, %lu ticks in %.3f s\n",
+               i, (unsigned long long) r->seed, r->first_score, r->second_score,
+               r->ticks, r->seconds);
+        total_ticks += r->ticks;
+        // in match order, whichever thread finished first
+        for (int b = 0; b < 64; b += 8) {
+            all_hash ^= (r->hash >> b) & 0xff;
+            all_hash *= 1099511628211ull;
+        }
+    }
+    printf("simulated %d match(es) of %dv%d, %lu ticks in %.3f s on %d thread(s) (%.0f ticks/sec)\n",
+           matches, team_size, team_size, total_ticks, elapsed, used_threads,
+           elapsed > 0.0 ? total_ticks / elapsed : 0.0);
+
+    if (profiler) {
+        if (lockstep)
+            printf("(lockstep matches are not profiled)\n");
+        profiler_dump(profiler, stdout);
+        profiler_destroy(profiler);
+    }
+
+    int status = 0;
+    if (hash) {
+        printf("hash %016llx (%s physics)\n", (unsigned long long) all_hash,
+#ifdef SOCCER_FIXED_POINT
+               "fixed-point"
+#else
+               "float"
+#endif
+               );
+        if (expect_hash && strtoull(expect_hash, NULL, 16) != all_hash) {
+            fprintf(stderr, "hash mismatch: expected %s\n", expect_hash);
+            status = 2;
+        }
+    }
+
+    free(record_names);
+    free(configs);
+    free(results);
+    return status;
+}
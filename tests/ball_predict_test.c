@@ -0,0 +1,85 @@
+/**
+ * @file ball_predict_test.c
+ * @brief The ball predictor must agree with the ball update_scene steps.
+ * * Rolls a free ball across the pitch at several speeds and tick rates,
+ * with every player lined up along the bottom edge out of its way, and
+ * compares each tick's position with ball_path_at_tick(). They may differ
+ * by rounding, not by a friction factor worked out another way; and the
+ * ball has to stop on the tick the path says.
+ */
+#include <math.h>
+#include <stdio.h>
+
+#include "core/constants.h"
+#include "entities/ball.h"
+#include "entities/player.h"
+#include "entities/team.h"
+#include "game/ball_predict.h"
+#include "game/scene.h"
+
+#define TOLERANCE 0.01f    // px, after several hundred ticks of rounding
+
+struct Roll {
+    struct Vec2 position;
+    struct Vec2 velocity;
+};
+
+/* None of these reaches a window edge: at a bounce the two differ on purpose. */
+static const struct Roll rolls[] = {
+    {{200.0f, 200.0f}, {800.0f, 0.0f}},
+    {{800.0f, 300.0f}, {-700.0f, 250.0f}},
+    {{500.0f, 150.0f}, {300.0f, 400.0f}},
+    {{400.0f, 250.0f}, {12.0f, 0.0f}},
+};
+
+static const int tick_rates[] = {30, 60, 120, 240};
+
+static int failures;
+
+static void check_roll(Scene* scene, const struct Roll* roll, int tick_rate) {
+    for (int i = 0; i < scene->team_size; i++) {
+        struct Player* a = scene->first_team->players[i];
+        struct Player* b = scene->second_team->players[i];
+        a->position = (struct Vec2){60.0f + 120.0f * i, SCREEN_HEIGHT - 40.0f};
+        b->position = (struct Vec2){120.0f + 120.0f * i, SCREEN_HEIGHT - 40.0f};
+        a->velocity = b->velocity = (struct Vec2){0, 0};
+    }
+    struct Ball* ball = scene->ball;
+    ball->position = roll->position;
+    ball->velocity = roll->velocity;
+    ball->possessor = NULL;
+    scene->state = STATE_RUNNING;
+
+    const float dt = 1.0f / (float)tick_rate;
+    struct BallPath path;
+    ball_path_init(&path, ball->position, ball->velocity, ball->radius, dt);
+
+    float worst = 0.0f;
+    int stopped = -1;   // first tick after which the engine's ball stood still
+    for (int n = 1; n <= path.stop_tick + 5; n++) {
+        update_scene(scene, dt);
+        const struct Vec2 want = ball_path_at_tick(&path, n);
+        const float off = hypotf(ball->position.x - want.x, ball->position.y - want.y);
+        if (off > worst) worst = off;
+        if (stopped < 0 && ball->velocity.x == 0.0f && ball->velocity.y == 0.0f) stopped = n;
+    }
+    if (worst > TOLERANCE || stopped != path.stop_tick || ball->possessor) {
+        printf("FAIL %d Hz, ball from (%g, %g) at (%g, %g): up to %g px off,"
+               " stopped after %d ticks, predicted %d\n",
+               tick_rate, roll->position.x, roll->position.y, roll->velocity.x, roll->velocity.y,
+               worst, stopped, path.stop_tick);
+        failures++;
+    }
+}
+
+int main(void) {
+    Scene* scene = scene_create(PLAYER_COUNT, 1, 0);
+    if (!scene) return 1;
+    for (size_t t = 0; t < sizeof(tick_rates) / sizeof(tick_rates[0]); t++)
+        for (size_t r = 0; r < sizeof(rolls) / sizeof(rolls[0]); r++)
+            check_roll(scene, &rolls[r], tick_rates[t]);
+    scene_destroy(scene);
+    if (failures == 0)
+        printf("ok\n");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,56 @@
+/**
+ * @file golden_test.c
+ * @brief Fixed-point builds must play the scripted matches to known hashes.
+ * * Only registered with -DSOCCER_FIXED_POINT=ON. The scripted coach
+ * (script.h) decides in fixed point too, so these matches come out bit for
+ * bit the same on every compiler, flag set and CPU. A hash that moves means
+ * the physics changed: if that was the point of the change, update the
+ * table with the values this test prints.
+ */
+#include <stdio.h>
+
+#include "script.h"
+#include "game/match.h"
+
+struct Golden {
+    int team_size;
+    uint64_t seed;
+    uint64_t hash;
+};
+
+static const struct Golden golden[] = {
+    {6, 1, 0xc38712ed814ef38bull},
+    {6, 2, 0x779f25b3a3f28589ull},
+    {6, 3, 0x1e375f000763d1b2ull},
+    {12, 1, 0xa44d0aed0f432a7aull},    // 24 slots: separation through the grid
+    {12, 2, 0x75258598c748877aull},
+};
+
+int main(void) {
+    int failures = 0;
+    script_reset_counts();
+    for (size_t i = 0; i < sizeof(golden) / sizeof(golden[0]); i++) {
+        const struct Golden* g = &golden[i];
+        const struct MatchConfig config = {.seed = g->seed, .team_size = g->team_size, .hash = 1,
+                                           .setup = script_setup};
+        struct MatchResult result;
+        play_match(&config, &result);
+        if (result.hash != g->hash) {
+            printf("FAIL %dv%d seed %llu: hash %016llx, expected %016llx (%u-%u in %lu ticks)\n",
+                   g->team_size, g->team_size, (unsigned long long)g->seed,
+                   (unsigned long long)result.hash, (unsigned long long)g->hash,
+                   result.first_score, result.second_score, result.ticks);
+            failures++;
+        }
+    }
+
+    const struct ScriptCounts seen = script_counts();
+    if (seen.crossings == 0 || seen.contacts == 0) {
+        printf("FAIL the script never put the ball out (%lu) or players together (%lu)\n",
+               seen.crossings, seen.contacts);
+        failures++;
+    }
+    if (failures == 0)
+        printf("ok\n");
+    return failures == 0 ? 0 : 1;
+}
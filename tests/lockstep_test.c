@@ -0,0 +1,56 @@
+/**
+ * @file lockstep_test.c
+ * @brief play_matches_lockstep must play every match exactly as play_match does.
+ * * Both run the scripted coach (script.h), so the ball crosses the pitch
+ * lines and players collide; the per-tick hashes, scores and tick counts
+ * of the two ways have to agree bit for bit.
+ */
+#include <stdio.h>
+
+#include "script.h"
+#include "game/match.h"
+
+#define MATCHES 5   // not a multiple of the SIMD width: padding lanes too
+
+static int failures;
+
+static void check_team_size(int team_size) {
+    struct MatchConfig configs[MATCHES];
+    struct MatchResult alone[MATCHES], batched[MATCHES];
+    for (int i = 0; i < MATCHES; i++)
+        configs[i] = (struct MatchConfig){.seed = 100 + i, .team_size = team_size, .hash = 1,
+                                          .setup = script_setup};
+
+    script_reset_counts();
+    for (int i = 0; i < MATCHES; i++)
+        play_match(&configs[i], &alone[i]);
+    const struct ScriptCounts seen = script_counts();
+    play_matches_lockstep(configs, batched, MATCHES);
+
+    if (seen.crossings == 0 || seen.contacts == 0) {
+        printf("FAIL %dv%d: the script never put the ball out (%lu) or players together (%lu)\n",
+               team_size, team_size, seen.crossings, seen.contacts);
+        failures++;
+    }
+    for (int i = 0; i < MATCHES; i++) {
+        const struct MatchResult* a = &alone[i];
+        const struct MatchResult* b = &batched[i];
+        if (a->hash != b->hash || a->ticks != b->ticks ||
+            a->first_score != b->first_score || a->second_score != b->second_score) {
+            printf("FAIL %dv%d seed %llu: play_match %u-%u in %lu ticks, hash %016llx;"
+                   " lockstep %u-%u in %lu ticks, hash %016llx\n",
+                   team_size, team_size, (unsigned long long)a->seed,
+                   a->first_score, a->second_score, a->ticks, (unsigned long long)a->hash,
+                   b->first_score, b->second_score, b->ticks, (unsigned long long)b->hash);
+            failures++;
+        }
+    }
+}
+
+int main(void) {
+    check_team_size(6);
+    check_team_size(16);    // separation through the grid
+    if (failures == 0)
+        printf("ok\n");
+    return failures == 0 ? 0 : 1;
+}
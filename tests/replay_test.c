@@ -0,0 +1,215 @@
+/**
+ * @file replay_test.c
+ * @brief A recorded match must read back as it was played.
+ * * Plays a scripted match (script.h) while recording it, and keeps every
+ * tick's frame as replay_capture() saw it. The file is then mapped with
+ * replay_open(): every frame has to decode to exactly the captured one, a
+ * seek to ticks between keyframes has to land on the same frame, and
+ * replay_apply() has to put the live match's positions back into a scene,
+ * to within the quantization step.
+ *
+ * The same match is also recorded into small files. Each of those has to
+ * end on the tick it reached segment_bytes, and the next one has to carry
+ * on from the tick after.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "script.h"
+#include "entities/ball.h"
+#include "entities/player.h"
+#include "entities/team.h"
+#include "game/replay.h"
+#include "game/scene.h"
+
+#define PREFIX "replay_test"
+#define ROTATED_PREFIX "replay_test_rotated"
+#define SEGMENT_BYTES 8192  // a dozen files
+#define TEAM_SIZE 6
+#define MATCH_SEED 42
+#define TICKS 1200          // 20 s, 20 keyframes
+#define KEYFRAME_INTERVAL 60
+
+/* ticks to seek to: keyframes, just before and after them, and the ends */
+static const uint32_t seeks[] = {1, 59, 60, 61, 150, 601, 1000, 1199, TICKS};
+#define SEEKS (sizeof(seeks) / sizeof(seeks[0]))
+
+/* What the live match looked like on a seek tick. */
+struct Live {
+    struct Vec2 ball;
+    struct Vec2 players[2 * TEAM_SIZE];
+    unsigned int scores[2];
+    int possessor;          // slot, or -1
+};
+
+static int failures;
+
+static void fail(const char* what, uint32_t tick) {
+    printf("FAIL tick %u: %s\n", tick, what);
+    failures++;
+}
+
+static bool near(struct Vec2 a, struct Vec2 b) {
+    const float step = 0.5f / REPLAY_SCALE + 1e-3f;
+    return fabsf(a.x - b.x) <= step && fabsf(a.y - b.y) <= step;
+}
+
+static bool same_frame(const struct ReplayFrame* frame, const int32_t* captured) {
+    return memcmp(frame->field, captured + (size_t)frame->field_count * frame->tick,
+                  sizeof(int32_t) * (size_t)frame->field_count) == 0;
+}
+
+static struct Live capture_live(const Scene* scene) {
+    struct Live live = {.ball = scene->ball->position,
+                        .scores = {scene->first_team->score, scene->second_team->score},
+                        .possessor = player_block_slot(&scene->players, scene->ball->possessor)};
+    for (int i = 0; i < scene->players.count; i++)
+        live.players[i] = scene->players.view[i]->position;
+    return live;
+}
+
+static void check_applied(Scene* scene, const struct ReplayFrame* frame, const struct Live* live) {
+    replay_apply(scene, frame, NULL);
+    if (!near(scene->ball->position, live->ball))
+        fail("ball isn't where it was", frame->tick);
+    for (int i = 0; i < scene->players.count; i++)
+        if (!near(scene->players.view[i]->position, live->players[i]))
+            fail("a player isn't where it was", frame->tick);
+    if (scene->first_team->score != live->scores[0] || scene->second_team->score != live->scores[1])
+        fail("wrong score", frame->tick);
+    if (player_block_slot(&scene->players, scene->ball->possessor) != live->possessor)
+        fail("wrong possessor", frame->tick);
+}
+
+/* Walks the rotated files in order; returns how many frames they hold. */
+static unsigned long check_rotation(const int32_t* captured, bool dropped) {
+    unsigned long frames = 0;
+    uint32_t expected_first = 1;
+    int files = 0;
+    for (;; files++) {
+        char path[64];
+        snprintf(path, sizeof(path), ROTATED_PREFIX "-%06d.rpl", files);
+        struct ReplayFile replay;
+        if (!replay_open(&replay, path)) break;
+        if (!dropped && replay.header.first_tick != expected_first)
+            fail("a file doesn't start where the last one stopped", replay.header.first_tick);
+
+        size_t last_start = 0;      // where the file's last frame begins
+        size_t start = REPLAY_HEADER_SIZE;
+        do {
+            if (replay.frame.tick < 1 || replay.frame.tick > TICKS || !same_frame(&replay.frame, captured)) {
+                fail("a rotated frame doesn't decode to what was captured", replay.frame.tick);
+                break;
+            }
+            last_start = start;
+            start = replay.next;
+            frames++;
+        } while (replay_next(&replay));
+
+        // every file but the last ends with the frame that took it to SEGMENT_BYTES
+        if (replay.last_tick != TICKS &&
+            (replay.frames_end < SEGMENT_BYTES || last_start >= SEGMENT_BYTES))
+            fail("a file wasn't closed on the tick it was due", replay.last_tick);
+        expected_first = replay.last_tick + 1;
+        replay_close(&replay);
+        remove(path);
+    }
+    if (files < 2 || expected_first != TICKS + 1) {
+        printf("FAIL %d rotated files, ending on tick %u\n", files, expected_first - 1);
+        failures++;
+    }
+    return frames;
+}
+
+int main(void) {
+    Scene* scene = scene_create(TEAM_SIZE, MATCH_SEED, 0);
+    if (!scene) return 1;
+    script_setup(scene, NULL);
+
+    const struct ReplayConfig config = {.prefix = PREFIX, .keyframe_interval = KEYFRAME_INTERVAL};
+    const struct ReplayConfig rotating = {.prefix = ROTATED_PREFIX, .keyframe_interval = KEYFRAME_INTERVAL,
+                                          .segment_bytes = SEGMENT_BYTES};
+    struct ReplayRecorder* recorder = replay_recorder_create(&config, MATCH_SEED, SIM_TICK_RATE);
+    struct ReplayRecorder* rotated = replay_recorder_create(&rotating, MATCH_SEED, SIM_TICK_RATE);
+    if (!recorder || !rotated) return 1;
+
+    // every tick's frame as captured, and the live scene on the seek ticks
+    struct ReplayFrame frame;
+    replay_capture(&frame, scene, 0);
+    const int fields = frame.field_count;
+    int32_t* captured = malloc(sizeof(int32_t) * (size_t)fields * (TICKS + 1));
+    struct Live live[SEEKS];
+    if (!captured) return 1;
+
+    for (uint32_t tick = 1; tick <= TICKS; tick++) {
+        update_scene(scene, 1.0f / SIM_TICK_RATE);
+        replay_record(recorder, scene, tick);
+        replay_record(rotated, scene, tick);
+        replay_capture(&frame, scene, tick);
+        memcpy(captured + (size_t)fields * tick, frame.field, sizeof(int32_t) * (size_t)fields);
+        for (size_t s = 0; s < SEEKS; s++)
+            if (seeks[s] == tick) live[s] = capture_live(scene);
+    }
+    const unsigned long dropped = replay_recorder_dropped(recorder);
+    const unsigned long rotated_dropped = replay_recorder_dropped(rotated);
+    replay_recorder_destroy(recorder);
+    replay_recorder_destroy(rotated);
+
+    struct ReplayFile replay;
+    if (!replay_open(&replay, PREFIX "-000000.rpl")) {
+        printf("FAIL can't open %s\n", PREFIX "-000000.rpl");
+        return 1;
+    }
+    if (replay.header.seed != MATCH_SEED || replay.header.tick_rate != SIM_TICK_RATE ||
+        replay.frame.field_count != fields || replay.last_tick != TICKS)
+        fail("header or last tick doesn't match the match", replay.last_tick);
+
+    // every frame, in order
+    unsigned long frames = 0;
+    do {
+        const uint32_t tick = replay.frame.tick;
+        if (tick < 1 || tick > TICKS) {
+            fail("frame outside the match", tick);
+            break;
+        }
+        if (!same_frame(&replay.frame, captured))
+            fail("frame doesn't decode to what was captured", tick);
+        frames++;
+    } while (replay_next(&replay));
+    if (frames + dropped != TICKS) {
+        printf("FAIL %lu frames read back, %lu dropped, %d played\n", frames, dropped, TICKS);
+        failures++;
+    }
+
+    // seeks, in no particular order, each compared with the live match
+    Scene* viewer = scene_create(TEAM_SIZE, MATCH_SEED, 0);
+    if (!viewer) return 1;
+    for (size_t i = 0; i < SEEKS; i++) {
+        const size_t s = (i * 5) % SEEKS;   // 5 and SEEKS share no factor: every seek once
+        if (!replay_seek(&replay, seeks[s]) || (dropped == 0 && replay.frame.tick != seeks[s])) {
+            fail("seek didn't land on the tick", seeks[s]);
+            continue;
+        }
+        if (replay.frame.tick != seeks[s]) continue;     // that tick was dropped
+        if (!same_frame(&replay.frame, captured))
+            fail("seek decoded a different frame", seeks[s]);
+        check_applied(viewer, &replay.frame, &live[s]);
+    }
+
+    replay_close(&replay);
+    remove(PREFIX "-000000.rpl");
+
+    frames = check_rotation(captured, rotated_dropped > 0);
+    if (frames + rotated_dropped != TICKS) {
+        printf("FAIL %lu rotated frames read back, %lu dropped, %d played\n", frames, rotated_dropped, TICKS);
+        failures++;
+    }
+    scene_destroy(viewer);
+    scene_destroy(scene);
+    free(captured);
+    if (failures == 0)
+        printf("ok\n");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,91 @@
+#include "script.h"
+#include "core/constants.h"
+#include "core/fixed.h"
+#include "entities/ball.h"
+#include "entities/player.h"
+#include "entities/team.h"
+#include "game/scene.h"
+
+static struct ScriptCounts counts;
+
+void script_reset_counts(void) {
+    counts = (struct ScriptCounts){0};
+}
+
+struct ScriptCounts script_counts(void) {
+    return counts;
+}
+
+/* Once per tick and scene: did last tick do what the tests are after? */
+static void count(const struct Scene* scene) {
+    if (scene->ball_sweep.kind != SWEEP_NONE)
+        counts.crossings++;
+
+    // from the players, not scene->players: lockstep matches don't fill that in
+    const int n = scene->team_size;
+    for (int i = 0; i < 2 * n; i++) {
+        const struct Player* a = i < n ? scene->first_team->players[i] : scene->second_team->players[i - n];
+        for (int j = i + 1; j < 2 * n; j++) {
+            const struct Player* b = j < n ? scene->first_team->players[j] : scene->second_team->players[j - n];
+            const struct FixedVec2 d = fvec2_sub(fvec2_from(b->position), fvec2_from(a->position));
+            const fixed reach = fixed_from_float(a->radius + b->radius + 0.5f);
+            if (fixed_length_sq(d.x, d.y) < fixed_length_sq(reach, 0)) {
+                counts.contacts++;
+                return;
+            }
+        }
+    }
+}
+
+/* `speed` px/s from `from` towards `to` */
+static struct Vec2 towards(struct Vec2 from, struct Vec2 to, float speed) {
+    const struct FixedVec2 d = fvec2_sub(fvec2_from(to), fvec2_from(from));
+    const fixed length = fvec2_length(d);
+    if (length == 0)
+        return (struct Vec2){0, 0};
+    const fixed s = fixed_from_float(speed);
+    return fvec2_to((struct FixedVec2){fixed_mul(fixed_div(d.x, length), s),
+                                       fixed_mul(fixed_div(d.y, length), s)});
+}
+
+static void change_state(struct Player* self, struct Scene* scene) {
+    const struct Ball* ball = scene->ball;
+    if (self->team == 1 && self->kit == 0)
+        count(scene);
+
+    const struct FixedVec2 d = fvec2_sub(fvec2_from(ball->position), fvec2_from(self->position));
+    const fixed reach = fixed_from_float(self->radius + ball->radius + 8.0f);
+    if (ball->possessor == self)
+        self->state = SHOOTING;
+    else if (fixed_length_sq(d.x, d.y) < fixed_length_sq(reach, 0))
+        self->state = INTERCEPTING;
+    else
+        self->state = MOVING;
+}
+
+static void movement(struct Player* self, struct Scene* scene) {
+    // different speeds, so the chasers bunch up and run into each other
+    self->velocity = towards(self->position, scene->ball->position, 120.0f + 15.0f * (float)(self->kit % 6));
+}
+
+static void shooting(struct Player* self, struct Scene* scene) {
+    // at the far goal, most kits wide of it: plenty of goals and outs
+    const struct Vec2 target = {
+        .x = self->team == 1 ? PITCH_X + PITCH_W : PITCH_X,
+        .y = CENTER_Y + 90.0f * (float)(self->kit % 5 - 2),
+    };
+    scene->ball->velocity = towards(scene->ball->position, target, 1500.0f);
+}
+
+void script_setup(struct Scene* scene, void* user) {
+    (void)user;
+    struct Team* teams[2] = {scene->first_team, scene->second_team};
+    for (int t = 0; t < 2; t++) {
+        for (int i = 0; i < scene->team_size; i++) {
+            struct Player* p = teams[t]->players[i];
+            p->change_state_logic = change_state;
+            p->movement_logic = movement;
+            p->shooting_logic = shooting;
+        }
+    }
+}
@@ -0,0 +1,36 @@
+/**
+ * @file script.h
+ * @brief A scripted coach for the tests: every player chases the ball and
+ * whoever gets it shoots at once.
+ * * The default coach leaves players standing still, so matches played with
+ * it never exercise collisions, tackles or balls leaving the pitch. This
+ * one does, every few seconds. Its decisions are made in fixed point
+ * (core/fixed.h), so it behaves the same in every build.
+ *
+ * Use it as MatchConfig.setup (game/match.h):
+ * @code
+ *   struct MatchConfig config = {.seed = 1, .hash = 1, .setup = script_setup};
+ * @endcode
+ */
+
+#ifndef TESTS_SCRIPT_H
+#define TESTS_SCRIPT_H
+
+struct Scene;
+
+/** @brief Gives every player in the scene the scripted logic; `user` is unused. */
+void script_setup(struct Scene* scene, void* user);
+
+/**
+ * @brief What the script has seen since script_reset_counts(), summed over
+ * every scene it plays in.
+ */
+struct ScriptCounts {
+    unsigned long crossings;    /**< Ticks in which the ball went over a pitch line. */
+    unsigned long contacts;     /**< Ticks in which two players overlapped. */
+};
+
+void script_reset_counts(void);
+struct ScriptCounts script_counts(void);
+
+#endif
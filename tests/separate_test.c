@@ -0,0 +1,62 @@
+/**
+ * @file separate_test.c
+ * @brief player_block_separate must give the same result with and without the grid.
+ * * Packs a 12v12 match into a 64 px cluster, so most players overlap
+ * several others and have many pushes to add up, and separates it both
+ * ways. Positions have to come out identical bit for bit.
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "core/rng.h"
+#include "entities/player.h"
+#include "entities/team.h"
+#include "game/scene.h"
+
+#define LAYOUTS 200
+#define CLUSTER 64
+
+int main(void) {
+    Scene* scene = scene_create(12, 1, 0);
+    if (!scene) return 1;
+    struct PlayerBlock* block = &scene->players;
+    struct Rng rng;
+    rng_seed(&rng, 7);
+
+    float x[PLAYER_BLOCK_CAPACITY(12)], y[PLAYER_BLOCK_CAPACITY(12)];
+    float brute_x[PLAYER_BLOCK_CAPACITY(12)], brute_y[PLAYER_BLOCK_CAPACITY(12)];
+    const size_t bytes = sizeof(float) * block->capacity;
+    int failures = 0;
+
+    for (int layout = 0; layout < LAYOUTS; layout++) {
+        const float cx = 100.0f + (float)rng_below(&rng, SCREEN_WIDTH - 200);
+        const float cy = 100.0f + (float)rng_below(&rng, SCREEN_HEIGHT - 200);
+        for (int i = 0; i < block->count; i++) {
+            struct Player* p = block->view[i];
+            p->position.x = cx + (float)rng_below(&rng, CLUSTER * 64) / 64.0f;
+            p->position.y = cy + (float)rng_below(&rng, CLUSTER * 64) / 64.0f;
+        }
+        player_block_gather(block);
+        memcpy(x, block->x, bytes);
+        memcpy(y, block->y, bytes);
+
+        player_block_separate(block, NULL);
+        memcpy(brute_x, block->x, bytes);
+        memcpy(brute_y, block->y, bytes);
+
+        memcpy(block->x, x, bytes);
+        memcpy(block->y, y, bytes);
+        spatial_grid_build(&scene->grid, block->x, block->y, block->view, 0, block->count);
+        player_block_separate(block, &scene->grid);
+
+        if (memcmp(brute_x, block->x, bytes) != 0 || memcmp(brute_y, block->y, bytes) != 0) {
+            printf("FAIL layout %d: the grid and every-pair separation disagree\n", layout);
+            failures++;
+        }
+    }
+
+    scene_destroy(scene);
+    if (failures == 0)
+        printf("ok\n");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,62 @@
+/**
+ * @file sweep_test.c
+ * @brief sweep_ball must find goals and outs anywhere along the ball's path.
+ * * Each case is one tick's path with what the referee's rules say about
+ * it (see game/sweep.h): a shot that crosses the line inside the mouth
+ * and ends up beside the net scores, one that clips a post on its way in
+ * doesn't, and one wide of a post is out.
+ */
+#include <math.h>
+#include <stdio.h>
+
+#include "core/constants.h"
+#include "game/sweep.h"
+
+#define RIGHT_LINE (PITCH_X + PITCH_W)
+#define LEFT_LINE PITCH_X
+#define POST_TOP ((float)(CENTER_Y - GOAL_HEIGHT / 2))
+#define POST_BOTTOM ((float)(CENTER_Y + GOAL_HEIGHT / 2))
+
+struct Case {
+    const char* name;
+    struct Vec2 from, to;
+    SweepKind kind;
+    int scorer;
+    bool post;
+    float x;        /**< Where the ball's centre is when it happens (to, for SWEEP_NONE). */
+};
+
+static const struct Case cases[] = {
+    // in the mouth when the whole ball is over the line, beside the net at the end of the tick
+    {"through the mouth, lands beside the net", {RIGHT_LINE - 40, POST_BOTTOM - 90},
+     {RIGHT_LINE + 35, POST_BOTTOM + 20}, SWEEP_GOAL, 1, false, RIGHT_LINE + BALL_RADIUS},
+    {"same on the left", {LEFT_LINE + 40, POST_BOTTOM - 90},
+     {LEFT_LINE - 35, POST_BOTTOM + 20}, SWEEP_GOAL, 2, false, LEFT_LINE - BALL_RADIUS},
+    // would be in the mouth when over the line, but touches the top post first
+    {"in off a post", {RIGHT_LINE - 30, POST_TOP - 5},
+     {RIGHT_LINE + 30, POST_TOP + 25}, SWEEP_OUT, 0, true, RIGHT_LINE + BALL_RADIUS},
+    // over the goal line above the top post, never touching it
+    {"wide of a post", {RIGHT_LINE - 30, POST_TOP - 30},
+     {RIGHT_LINE + 30, POST_TOP - 20}, SWEEP_OUT, 0, false, RIGHT_LINE + BALL_RADIUS},
+    {"over a touch line", {CENTER_X, PITCH_Y + 20},
+     {CENTER_X + 10, PITCH_Y - 40}, SWEEP_OUT, 0, false, CENTER_X + 5},
+    {"stays in play", {CENTER_X, CENTER_Y}, {CENTER_X + 200, CENTER_Y + 50},
+     SWEEP_NONE, 0, false, CENTER_X + 200},
+};
+
+int main(void) {
+    int failures = 0;
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        const struct Case* c = &cases[i];
+        const struct Sweep s = sweep_ball(c->from, c->to, BALL_RADIUS);
+        if (s.kind != c->kind || s.scorer != c->scorer || s.post != c->post ||
+            fabsf(s.point.x - c->x) > 1e-3f || s.t < 0.0f || s.t > 1.0f) {
+            printf("FAIL %s: kind %d, scorer %d, post %d, t %g at (%g, %g)\n",
+                   c->name, (int)s.kind, s.scorer, (int)s.post, s.t, s.point.x, s.point.y);
+            failures++;
+        }
+    }
+    if (failures == 0)
+        printf("ok\n");
+    return failures == 0 ? 0 : 1;
+}